@@ -0,0 +1,69 @@
+/**
+ * @file ChunkedBodyBench.cpp
+ *
+ * This module contains the microbenchmarks of the
+ * Http::ChunkedBody class.
+ *
+ * © 2018 by Richard Walters
+ */
+
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <Http/ChunkedBody.hpp>
+#include <string>
+#include <StringExtensions/StringExtensions.hpp>
+
+namespace {
+
+    /**
+     * This is the total number of body characters to deliver
+     * through the chunked transfer coding in each benchmark iteration.
+     */
+    constexpr size_t TOTAL_BODY_SIZE = 64 << 10;
+
+    /**
+     * This function encodes a body of TOTAL_BODY_SIZE characters
+     * using the chunked transfer coding, cut into chunks of the
+     * given size.
+     *
+     * @param[in] chunkSize
+     *     This is the number of body characters to place in each chunk.
+     *
+     * @return
+     *     The chunked-encoded body is returned.
+     */
+    std::string MakeChunkedEncoding(size_t chunkSize) {
+        std::string encoding;
+        size_t bodyRemaining = TOTAL_BODY_SIZE;
+        while (bodyRemaining > 0) {
+            const auto thisChunkSize = std::min(chunkSize, bodyRemaining);
+            encoding += StringExtensions::sprintf("%zx\r\n", thisChunkSize);
+            encoding.append(thisChunkSize, 'X');
+            encoding += "\r\n";
+            bodyRemaining -= thisChunkSize;
+        }
+        encoding += "0\r\n\r\n";
+        return encoding;
+    }
+
+    /**
+     * This benchmark measures decoding a 64 kB chunked body delivered
+     * in one piece, with the chunk size varied across runs.
+     */
+    void BM_ChunkedBodyDecode(benchmark::State& state) {
+        const auto encoding = MakeChunkedEncoding((size_t)state.range(0));
+        for (auto _: state) {
+            Http::ChunkedBody chunkedBody;
+            benchmark::DoNotOptimize(chunkedBody.Decode(encoding));
+        }
+        state.SetBytesProcessed(
+            state.iterations() * (int64_t)encoding.length()
+        );
+    }
+    BENCHMARK(BM_ChunkedBodyDecode)
+        ->Arg(64)
+        ->Arg(512)
+        ->Arg(4 << 10)
+        ->Arg(32 << 10);
+
+}
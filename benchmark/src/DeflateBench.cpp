@@ -0,0 +1,84 @@
+/**
+ * @file DeflateBench.cpp
+ *
+ * This module contains the microbenchmarks of the
+ * Http::Deflate and Http::Inflate functions.
+ *
+ * © 2018 by Richard Walters
+ */
+
+#include <benchmark/benchmark.h>
+#include <Deflate.hpp>
+#include <Inflate.hpp>
+#include <stdlib.h>
+#include <string>
+
+namespace {
+
+    /**
+     * This function makes a body of the given size with enough
+     * variety to give the compressor realistic work to do.
+     *
+     * @param[in] bodySize
+     *     This is the number of characters to place in the body.
+     *
+     * @return
+     *     The constructed body is returned.
+     */
+    std::string MakeBody(size_t bodySize) {
+        static const std::string sample(
+            "The quick brown fox jumps over the lazy dog.  "
+        );
+        std::string body;
+        body.reserve(bodySize);
+        while (body.length() < bodySize) {
+            body += sample;
+        }
+        body.resize(bodySize);
+        return body;
+    }
+
+    /**
+     * This benchmark measures compressing bodies of various sizes
+     * with the "deflate" coding.
+     */
+    void BM_Deflate(benchmark::State& state) {
+        const auto body = MakeBody((size_t)state.range(0));
+        for (auto _: state) {
+            benchmark::DoNotOptimize(
+                Http::Deflate(body, Http::DeflateMode::Deflate)
+            );
+        }
+        state.SetBytesProcessed(
+            state.iterations() * (int64_t)body.length()
+        );
+    }
+    BENCHMARK(BM_Deflate)->Arg(1 << 10)->Arg(64 << 10)->Arg(1 << 20);
+
+    /**
+     * This benchmark measures decompressing bodies of various sizes
+     * with the "deflate" coding.
+     */
+    void BM_Inflate(benchmark::State& state) {
+        const auto body = MakeBody((size_t)state.range(0));
+        const auto deflatedBody = Http::Deflate(body, Http::DeflateMode::Deflate);
+        std::string inflatedBody;
+        for (auto _: state) {
+            if (
+                !Http::Inflate(
+                    deflatedBody,
+                    inflatedBody,
+                    Http::InflateMode::Inflate
+                )
+            ) {
+                state.SkipWithError("unable to inflate body");
+                break;
+            }
+        }
+        state.SetBytesProcessed(
+            state.iterations() * (int64_t)body.length()
+        );
+    }
+    BENCHMARK(BM_Inflate)->Arg(1 << 10)->Arg(64 << 10)->Arg(1 << 20);
+
+}
@@ -0,0 +1,71 @@
+/**
+ * @file ResponseBench.cpp
+ *
+ * This module contains the microbenchmarks of the
+ * Http::Response structure.
+ *
+ * © 2018 by Richard Walters
+ */
+
+#include <benchmark/benchmark.h>
+#include <Http/Response.hpp>
+#include <string>
+#include <StringExtensions/StringExtensions.hpp>
+
+namespace {
+
+    /**
+     * This function makes a typical HTTP response with the given
+     * body size, ready to be serialized.
+     *
+     * @param[in] bodySize
+     *     This is the number of characters to place in the response body.
+     *
+     * @return
+     *     The constructed response is returned.
+     */
+    Http::Response MakeResponse(size_t bodySize) {
+        Http::Response response;
+        response.statusCode = 200;
+        response.reasonPhrase = "OK";
+        response.headers.AddHeader("Date", "Mon, 27 Jul 2009 12:28:53 GMT");
+        response.headers.AddHeader("Accept-Ranges", "bytes");
+        response.headers.AddHeader("Content-Type", "text/plain");
+        response.body.assign(bodySize, 'X');
+        response.headers.AddHeader(
+            "Content-Length",
+            StringExtensions::sprintf("%zu", bodySize)
+        );
+        return response;
+    }
+
+    /**
+     * This benchmark measures serializing a complete response,
+     * head and body, into a fresh string.
+     */
+    void BM_ResponseGenerate(benchmark::State& state) {
+        const auto response = MakeResponse((size_t)state.range(0));
+        for (auto _: state) {
+            benchmark::DoNotOptimize(response.Generate());
+        }
+        state.SetBytesProcessed(
+            state.iterations() * (int64_t)response.body.length()
+        );
+    }
+    BENCHMARK(BM_ResponseGenerate)->Arg(0)->Arg(1024)->Arg(64 << 10);
+
+    /**
+     * This benchmark measures serializing just the head of a response
+     * into a reused buffer, as done on the vectored send path.
+     */
+    void BM_ResponseGenerateTo(benchmark::State& state) {
+        const auto response = MakeResponse(1024);
+        std::string head;
+        for (auto _: state) {
+            response.GenerateTo(head);
+            benchmark::DoNotOptimize(head);
+        }
+    }
+    BENCHMARK(BM_ResponseGenerateTo);
+
+}
@@ -0,0 +1,291 @@
+/**
+ * @file ServerBench.cpp
+ *
+ * This module contains the microbenchmarks of the
+ * Http::Server class.
+ *
+ * © 2018 by Richard Walters
+ */
+
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <Http/Connection.hpp>
+#include <Http/Server.hpp>
+#include <Http/ServerTransport.hpp>
+#include <inttypes.h>
+#include <memory>
+#include <stdint.h>
+#include <string>
+#include <StringExtensions/StringExtensions.hpp>
+#include <vector>
+
+namespace {
+
+    /**
+     * This is a fake connection which delivers canned requests to the
+     * server and discards its responses.
+     */
+    struct BenchConnection
+        : public Http::Connection
+    {
+        // Properties
+
+        /**
+         * This is the delegate to call whenever data is received from
+         * the remote peer.
+         */
+        DataReceivedDelegate dataReceivedDelegate;
+
+        /**
+         * This is the delegate to call whenever the connection
+         * has been broken.
+         */
+        BrokenDelegate brokenDelegate;
+
+        // Http::Connection
+
+        virtual std::string GetPeerAddress() override {
+            return "bench-client";
+        }
+
+        virtual std::string GetPeerId() override {
+            return "bench-client:5555";
+        }
+
+        virtual void SetDataReceivedDelegate(DataReceivedDelegate newDataReceivedDelegate) override {
+            dataReceivedDelegate = newDataReceivedDelegate;
+        }
+
+        virtual void SetBrokenDelegate(BrokenDelegate newBrokenDelegate) override {
+            brokenDelegate = newBrokenDelegate;
+        }
+
+        virtual void SendData(const std::vector< uint8_t >& data) override {
+        }
+
+        virtual void Break(bool clean) override {
+        }
+    };
+
+    /**
+     * This is a fake transport layer which hands connections
+     * directly to the server.
+     */
+    struct BenchTransport
+        : public Http::ServerTransport
+    {
+        // Properties
+
+        /**
+         * This is the delegate to call whenever a new connection
+         * has been established for the server.
+         */
+        NewConnectionDelegate newConnectionDelegate;
+
+        // Http::ServerTransport
+
+        virtual bool BindNetwork(
+            uint16_t port,
+            NewConnectionDelegate newConnectionDelegate
+        ) override {
+            this->newConnectionDelegate = newConnectionDelegate;
+            return true;
+        }
+
+        virtual uint16_t GetBoundPort() override {
+            return 1234;
+        }
+
+        virtual void ReleaseNetwork() override {
+        }
+    };
+
+    /**
+     * This is a fake time-keeper which stands still, so that no
+     * timeouts or rate limits interfere with the benchmarks.
+     */
+    struct BenchTimeKeeper
+        : public Http::TimeKeeper
+    {
+        // Http::TimeKeeper
+
+        virtual double GetCurrentTime() override {
+            return 0.0;
+        }
+    };
+
+    /**
+     * This benchmark measures parsing a minimal GET request.
+     */
+    void BM_ParseRequestMinimalGet(benchmark::State& state) {
+        Http::Server server;
+        const std::string rawRequest(
+            "GET /hello.txt HTTP/1.1\r\n"
+            "Host: www.example.com\r\n"
+            "\r\n"
+        );
+        for (auto _: state) {
+            benchmark::DoNotOptimize(server.ParseRequest(rawRequest));
+        }
+        state.SetBytesProcessed(
+            state.iterations() * (int64_t)rawRequest.length()
+        );
+    }
+    BENCHMARK(BM_ParseRequestMinimalGet);
+
+    /**
+     * This benchmark measures parsing a GET request carrying
+     * thirty headers.
+     */
+    void BM_ParseRequestManyHeaders(benchmark::State& state) {
+        Http::Server server;
+        std::string rawRequest(
+            "GET /hello.txt HTTP/1.1\r\n"
+            "Host: www.example.com\r\n"
+        );
+        for (size_t i = 0; i < 30; ++i) {
+            rawRequest += StringExtensions::sprintf(
+                "X-Header-%zu: value-%zu\r\n",
+                i, i
+            );
+        }
+        rawRequest += "\r\n";
+        for (auto _: state) {
+            benchmark::DoNotOptimize(server.ParseRequest(rawRequest));
+        }
+        state.SetBytesProcessed(
+            state.iterations() * (int64_t)rawRequest.length()
+        );
+    }
+    BENCHMARK(BM_ParseRequestManyHeaders);
+
+    /**
+     * This benchmark measures parsing a POST request carrying
+     * a one-megabyte body.
+     */
+    void BM_ParseRequestLargePost(benchmark::State& state) {
+        Http::Server server;
+        const std::string body((size_t)1 << 20, 'X');
+        server.SetConfigurationItem(
+            "MaxMessageSize",
+            StringExtensions::sprintf("%zu", body.length() + 1024)
+        );
+        const auto rawRequest = StringExtensions::sprintf(
+            "POST /uploads HTTP/1.1\r\n"
+            "Host: www.example.com\r\n"
+            "Content-Length: %zu\r\n"
+            "\r\n",
+            body.length()
+        ) + body;
+        for (auto _: state) {
+            benchmark::DoNotOptimize(server.ParseRequest(rawRequest));
+        }
+        state.SetBytesProcessed(
+            state.iterations() * (int64_t)rawRequest.length()
+        );
+    }
+    BENCHMARK(BM_ParseRequestLargePost);
+
+    /**
+     * This benchmark measures parsing a request delivered in small
+     * fragments, as from a slow network, where the parser is handed
+     * a little more of the message on each call.
+     */
+    void BM_ParseRequestFragmented(benchmark::State& state) {
+        Http::Server server;
+        std::string rawRequest(
+            "GET /hello.txt HTTP/1.1\r\n"
+            "Host: www.example.com\r\n"
+        );
+        for (size_t i = 0; i < 30; ++i) {
+            rawRequest += StringExtensions::sprintf(
+                "X-Header-%zu: value-%zu\r\n",
+                i, i
+            );
+        }
+        rawRequest += "\r\n";
+        const size_t fragmentSize = 64;
+        for (auto _: state) {
+            for (
+                size_t deliveredSoFar = fragmentSize;
+                deliveredSoFar < rawRequest.length() + fragmentSize;
+                deliveredSoFar += fragmentSize
+            ) {
+                benchmark::DoNotOptimize(
+                    server.ParseRequest(
+                        rawRequest.substr(
+                            0,
+                            std::min(deliveredSoFar, rawRequest.length())
+                        )
+                    )
+                );
+            }
+        }
+        state.SetBytesProcessed(
+            state.iterations() * (int64_t)rawRequest.length()
+        );
+    }
+    BENCHMARK(BM_ParseRequestFragmented);
+
+    /**
+     * This benchmark measures dispatching a request through the
+     * server's resource router, with the depth of the registered
+     * resource path varied across runs.
+     */
+    void BM_RouterDispatch(benchmark::State& state) {
+        const auto depth = (size_t)state.range(0);
+        Http::Server server;
+        const auto transport = std::make_shared< BenchTransport >();
+        Http::Server::MobilizationDependencies deps;
+        deps.transport = transport;
+        deps.timeKeeper = std::make_shared< BenchTimeKeeper >();
+        server.SetConfigurationItem("TooManyRequestsThreshold", "0.0");
+        if (!server.Mobilize(deps)) {
+            state.SkipWithError("unable to mobilize server");
+            return;
+        }
+        std::vector< std::string > resourceSubspacePath;
+        std::string target;
+        for (size_t i = 0; i < depth; ++i) {
+            const auto segment = StringExtensions::sprintf("segment-%zu", i);
+            resourceSubspacePath.push_back(segment);
+            target += "/" + segment;
+        }
+        const auto unregister = server.RegisterResource(
+            resourceSubspacePath,
+            [](
+                const Http::Request& request,
+                std::shared_ptr< Http::Connection > connection,
+                const std::string& trailer
+            ){
+                Http::Response response;
+                response.statusCode = 200;
+                response.reasonPhrase = "OK";
+                response.headers.SetHeader("Content-Length", "0");
+                return response;
+            }
+        );
+        const auto connection = std::make_shared< BenchConnection >();
+        const auto connectionReady = transport->newConnectionDelegate(connection);
+        if (connectionReady != nullptr) {
+            connectionReady();
+        }
+        const auto rawRequest = StringExtensions::sprintf(
+            "GET %s HTTP/1.1\r\n"
+            "Host: www.example.com\r\n"
+            "\r\n",
+            target.c_str()
+        );
+        const std::vector< uint8_t > rawRequestAsBytes(
+            rawRequest.begin(),
+            rawRequest.end()
+        );
+        for (auto _: state) {
+            connection->dataReceivedDelegate(rawRequestAsBytes);
+        }
+        unregister();
+        state.SetItemsProcessed(state.iterations());
+    }
+    BENCHMARK(BM_RouterDispatch)->Arg(1)->Arg(2)->Arg(4)->Arg(8);
+
+}
@@ -125,6 +125,16 @@ namespace Http {
          */
         operator std::string() const;
 
+        /**
+         * This method moves the decoded body out of the decoder,
+         * without copying it, leaving the decoder's own copy empty.
+         * It should only be called once the decoding is complete.
+         *
+         * @return
+         *     The body as a string is returned.
+         */
+        std::string TakeBody();
+
         /**
          * This method returns an object holding any trailers
          * that were attached to the chunked body.
@@ -25,6 +25,7 @@
 #include <string>
 #include <SystemAbstractions/DiagnosticsSender.hpp>
 #include <Timekeeping/Scheduler.hpp>
+#include <vector>
 
 namespace Http {
 
@@ -55,6 +56,19 @@ namespace Http {
          */
         static constexpr double DEFAULT_INACTIVITY_INTERVAL_SECONDS = 60.0;
 
+        /**
+         * This is the default maximum number of persistent connections
+         * the client will hold open to any one server at the same time.
+         */
+        static constexpr size_t DEFAULT_MAX_CONNECTIONS_PER_SERVER = 6;
+
+        /**
+         * This is the default maximum number of requests the client will
+         * have in flight on any one connection at the same time.  The
+         * default of one means requests are never pipelined.
+         */
+        static constexpr size_t DEFAULT_MAX_PIPELINE_DEPTH = 1;
+
         // Types
     public:
         /**
@@ -86,6 +100,32 @@ namespace Http {
              * does not reuse the connection.
              */
             double inactivityInterval = DEFAULT_INACTIVITY_INTERVAL_SECONDS;
+
+            /**
+             * This is the maximum number of persistent connections the
+             * client will hold open to any one server at the same time.
+             * Requests made while all of a server's pooled connections
+             * are busy open their own connections, which are closed once
+             * their transactions complete.  A value of zero means there
+             * is no limit.
+             */
+            size_t maxConnectionsPerServer = DEFAULT_MAX_CONNECTIONS_PER_SERVER;
+
+            /**
+             * This is the maximum number of requests the client may have
+             * in flight on any one connection at the same time.  When
+             * this is greater than one, a request with an idempotent
+             * method made while all of a server's pooled connections are
+             * busy may be pipelined behind the requests already in
+             * flight on one of them, rather than opening another
+             * connection.  Responses are matched to pipelined requests
+             * in the order the requests were sent.  If a connection is
+             * lost while pipelined requests are still awaiting their
+             * responses, those requests are sent again through other
+             * connections, which is safe because only idempotent
+             * requests are ever pipelined.
+             */
+            size_t maxPipelineDepth = DEFAULT_MAX_PIPELINE_DEPTH;
         };
 
         // Lifecycle management
@@ -194,6 +234,10 @@ namespace Http {
             bool persistConnection = true,
             UpgradeDelegate upgradeDelegate = nullptr
         ) override;
+        virtual std::vector< std::shared_ptr< Transaction > > RequestMany(
+            std::vector< Http::Request > requests,
+            bool persistConnection = true
+        ) override;
 
         // Private properties
     private:
@@ -9,9 +9,13 @@
  * © 2018 by Richard Walters
  */
 
+#include <algorithm>
 #include <functional>
+#include <limits.h>
 #include <memory>
+#include <stddef.h>
 #include <stdint.h>
+#include <stdio.h>
 #include <string>
 #include <vector>
 
@@ -34,6 +38,41 @@ namespace Http {
          */
         typedef std::function< void(const std::vector< uint8_t >& data) > DataReceivedDelegate;
 
+        /**
+         * This represents one span of bytes to be sent to the remote peer
+         * as part of a vectored send.  The bytes are borrowed from the
+         * caller, and must remain valid until the send call returns.
+         */
+        struct BufferView {
+            /**
+             * This points to the first byte of the span.
+             */
+            const uint8_t* data;
+
+            /**
+             * This is the number of bytes in the span.
+             */
+            size_t length;
+
+            /**
+             * Construct a new view of the given span of bytes.
+             *
+             * @param[in] data
+             *     This points to the first byte of the span.
+             *
+             * @param[in] length
+             *     This is the number of bytes in the span.
+             */
+            BufferView(
+                const uint8_t* data,
+                size_t length
+            )
+                : data(data)
+                , length(length)
+            {
+            }
+        };
+
         /**
          * This is the type of delegate used to notify the user that
          * the connection has been broken.
@@ -45,6 +84,14 @@ namespace Http {
          */
         typedef std::function< void(bool graceful) > BrokenDelegate;
 
+        /**
+         * This is the type of delegate used to notify the user that
+         * the connection's send queue has drained back down to the
+         * low watermark, and so more data may be sent without the
+         * queue growing out of hand.
+         */
+        typedef std::function< void() > WritableDelegate;
+
         // Methods
 
         /**
@@ -97,6 +144,146 @@ namespace Http {
          */
         virtual void SendData(const std::vector< uint8_t >& data) = 0;
 
+        /**
+         * This method sends the given sequence of byte spans to the
+         * remote peer, as if they were concatenated into a single
+         * sequence of bytes.
+         *
+         * Transports capable of scatter/gather I/O should override this
+         * method to hand the spans to the transport without copying them.
+         * The default implementation gathers the spans into a single
+         * buffer and sends that.
+         *
+         * @param[in] buffers
+         *     These are the spans of bytes to send to the remote peer.
+         */
+        virtual void SendData(const std::vector< BufferView >& buffers) {
+            size_t totalLength = 0;
+            for (const auto& buffer: buffers) {
+                totalLength += buffer.length;
+            }
+            std::vector< uint8_t > data;
+            data.reserve(totalLength);
+            for (const auto& buffer: buffers) {
+                data.insert(
+                    data.end(),
+                    buffer.data,
+                    buffer.data + buffer.length
+                );
+            }
+            SendData(data);
+        }
+
+        /**
+         * This method sends the contents of the given region of a file
+         * to the remote peer.
+         *
+         * Transports able to splice file contents onto the connection
+         * without copying them through user space (such as with
+         * sendfile or TransmitFile) should override this method to
+         * hand the region to the transport.  The default implementation
+         * reads the region into a buffer and sends that.
+         *
+         * If the region cannot be read in full, the connection is
+         * broken abruptly, since the remote peer was promised bytes
+         * which can no longer be delivered.
+         *
+         * @param[in] path
+         *     This is the path to the file whose contents should be
+         *     sent to the remote peer.
+         *
+         * @param[in] offset
+         *     This is the offset, in bytes, into the file at which
+         *     the region begins.
+         *
+         * @param[in] length
+         *     This is the size of the region, in bytes.
+         */
+        virtual void SendFile(
+            const std::string& path,
+            size_t offset,
+            size_t length
+        ) {
+            FILE* file = fopen(path.c_str(), "rb");
+            if (file == NULL) {
+                Break(false);
+                return;
+            }
+
+            // fseek takes a long offset, which is only 32 bits on some
+            // platforms, so seek in steps no larger than LONG_MAX
+            // rather than truncating the offset and sending the wrong
+            // bytes.
+            size_t offsetRemaining = offset;
+            int seekOrigin = SEEK_SET;
+            do {
+                const auto seekStep = std::min< size_t >(
+                    offsetRemaining,
+                    (size_t)LONG_MAX
+                );
+                if (fseek(file, (long)seekStep, seekOrigin) != 0) {
+                    (void)fclose(file);
+                    Break(false);
+                    return;
+                }
+                offsetRemaining -= seekStep;
+                seekOrigin = SEEK_CUR;
+            } while (offsetRemaining > 0);
+            std::vector< uint8_t > buffer;
+            while (length > 0) {
+                buffer.resize(std::min< size_t >(length, 65536));
+                if (fread(buffer.data(), 1, buffer.size(), file) != buffer.size()) {
+                    (void)fclose(file);
+                    Break(false);
+                    return;
+                }
+                SendData(buffer);
+                length -= buffer.size();
+            }
+            (void)fclose(file);
+        }
+
+        /**
+         * This method returns the number of bytes which have been
+         * accepted for sending but not yet handed off to the network.
+         *
+         * Transports able to report how much data is still queued for
+         * sending should override this method.  The default
+         * implementation reports an empty queue, as if every byte were
+         * handed off to the network the moment it was accepted.
+         *
+         * @return
+         *     The number of bytes which have been accepted for sending
+         *     but not yet handed off to the network is returned.
+         */
+        virtual size_t GetSendQueueSize() {
+            return 0;
+        }
+
+        /**
+         * This method sets the delegate to call whenever the
+         * connection's send queue drains from above the given low
+         * watermark back down to or below it.
+         *
+         * Transports able to report how much data is still queued for
+         * sending should override this method.  The default
+         * implementation does nothing, meaning the delegate is
+         * never called.
+         *
+         * @param[in] writableDelegate
+         *     This is the delegate to call whenever the connection's
+         *     send queue drains back down to the low watermark.
+         *
+         * @param[in] lowWatermark
+         *     This is the size of the send queue, in bytes, at or below
+         *     which the delegate should be called.
+         */
+        virtual void SetWritableDelegate(
+            WritableDelegate,
+            size_t
+        ) {
+        }
+
         /**
          * This method breaks the connection to the remote peer.
          *
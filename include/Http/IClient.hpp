@@ -15,7 +15,10 @@
 
 #include <chrono>
 #include <functional>
+#include <memory>
+#include <stddef.h>
 #include <SystemAbstractions/DiagnosticsSender.hpp>
+#include <vector>
 
 namespace Http {
 
@@ -220,6 +223,82 @@ namespace Http {
             bool persistConnection = true,
             UpgradeDelegate upgradeDelegate = nullptr
         ) = 0;
+
+        /**
+         * This method asynchronously posts the given requests for resources
+         * on the Internet, all at once.
+         *
+         * The default implementation simply posts each request in turn
+         * through the Request method.  Implementations may override it to
+         * reduce per-request overhead, such as by grouping requests made
+         * to the same server so that they can share connections.
+         *
+         * @param[in] requests
+         *     These are the requests to make.  The servers' addresses
+         *     are obtained from the requests' target URIs.
+         *
+         * @param[in] persistConnection
+         *     This flag indicates whether or not the connections used to
+         *     communicate with the servers should be kept open after the
+         *     requests, possibly to be reused in subsequent requests.
+         *
+         * @return
+         *     Objects representing the resource requests are returned,
+         *     in the same order as the given requests.
+         */
+        virtual std::vector< std::shared_ptr< Transaction > > RequestMany(
+            std::vector< Http::Request > requests,
+            bool persistConnection = true
+        );
+
+        /**
+         * This method can be used to wait for all of the given transactions
+         * to complete.
+         *
+         * @param[in] transactions
+         *     These are the transactions for which to wait.
+         *
+         * @param[in] relativeTime
+         *     This is the maximum amount of time, in milliseconds,
+         *     to wait for all of the transactions to complete.
+         *
+         * @return
+         *     An indication of whether or not all of the transactions were
+         *     completed in time is returned.
+         */
+        static bool AwaitAllCompletions(
+            const std::vector< std::shared_ptr< Transaction > >& transactions,
+            const std::chrono::milliseconds& relativeTime
+        );
+
+        /**
+         * This method can be used to wait for any one of the given
+         * transactions to complete.
+         *
+         * @note
+         *     This method installs its own completion delegate in each of
+         *     the given transactions, replacing any completion delegate
+         *     previously set through SetCompletionDelegate.
+         *
+         * @param[in] transactions
+         *     These are the transactions for which to wait.
+         *
+         * @param[in] relativeTime
+         *     This is the maximum amount of time, in milliseconds,
+         *     to wait for one of the transactions to complete.
+         *
+         * @return
+         *     The index (into the given collection) of a transaction which
+         *     has completed is returned.
+         *
+         * @retval transactions.size()
+         *     This is returned if none of the transactions completed
+         *     in time.
+         */
+        static size_t AwaitAnyCompletion(
+            const std::vector< std::shared_ptr< Transaction > >& transactions,
+            const std::chrono::milliseconds& relativeTime
+        );
     };
 
 }
@@ -62,6 +62,232 @@ namespace Http {
             )
         > ResourceDelegate;
 
+        /**
+         * This is the interface given to streamed resource handlers
+         * through which to send their responses back to the client
+         * a piece at a time, rather than having to materialize the
+         * entire response body in memory up front.
+         */
+        class ResponseWriter {
+        public:
+            // Types
+
+            /**
+             * This is the type of function to call if the connection
+             * is broken before the response is finished.
+             */
+            typedef std::function< void() > AbandonedDelegate;
+
+            /**
+             * This is the type of function to call whenever the
+             * connection's send queue drains back down to the server's
+             * configured low watermark, meaning more of the response
+             * body may be sent without the queue growing out of hand.
+             */
+            typedef std::function< void() > WritableDelegate;
+
+            // Methods
+
+            /**
+             * This method sends the status line and headers of the given
+             * response to the client immediately.  If the response has
+             * neither a "Content-Length" header nor a chunked
+             * "Transfer-Encoding" header, a chunked "Transfer-Encoding"
+             * header is added, and each piece of the body subsequently
+             * sent through SendBodyChunk is framed using the chunked
+             * transfer coding
+             * ([RFC 7230](https://tools.ietf.org/html/rfc7230)
+             * section 4.1).
+             *
+             * @param[in,out] response
+             *     This is the response whose status line and headers
+             *     should be sent to the client.  Its body, if any, is
+             *     ignored; the body should be sent through SendBodyChunk.
+             */
+            virtual void SendResponseHeaders(Response& response) = 0;
+
+            /**
+             * This method sends the given piece of the response body
+             * to the client.  The status line and headers must have been
+             * sent first, through SendResponseHeaders.
+             *
+             * @param[in] chunk
+             *     This is the piece of the response body to send to the
+             *     client.  It must not be empty, since an empty chunk
+             *     would terminate the chunked transfer coding.
+             */
+            virtual void SendBodyChunk(const std::string& chunk) = 0;
+
+            /**
+             * This method completes the response, sending the last-chunk
+             * marker if the chunked transfer coding is in use.  Once the
+             * response is complete, the server resumes processing
+             * any subsequent requests received on the connection.
+             */
+            virtual void FinishResponse() = 0;
+
+            /**
+             * This method sets the function to call if the connection is
+             * broken before FinishResponse is called.  A handler which
+             * holds onto the response writer after returning, such as one
+             * streaming server-sent events, should use this to learn when
+             * to stop.
+             *
+             * @param[in] abandonedDelegate
+             *     This is the function to call if the connection is broken
+             *     before the response is finished.
+             */
+            virtual void SetAbandonedDelegate(AbandonedDelegate abandonedDelegate) = 0;
+
+            /**
+             * This method returns the number of bytes of the response
+             * which have been accepted for sending but not yet handed
+             * off to the network.  A handler streaming a large body
+             * should use this to pace itself against a slow client,
+             * rather than queueing the entire body at once.  Transports
+             * without send queue visibility always report an
+             * empty queue.
+             *
+             * @return
+             *     The number of bytes of the response which have been
+             *     accepted for sending but not yet handed off to the
+             *     network is returned.
+             */
+            virtual size_t GetSendQueueSize() = 0;
+
+            /**
+             * This method sets the function to call whenever the
+             * connection's send queue drains from above the server's
+             * configured low watermark (the "SendQueueLowWatermark"
+             * configuration item) back down to or below it.  A handler
+             * which stops sending when GetSendQueueSize grows too
+             * large should use this to learn when to resume.  For
+             * transports without send queue visibility, the function
+             * is never called.
+             *
+             * @param[in] writableDelegate
+             *     This is the function to call whenever the connection's
+             *     send queue drains back down to the low watermark.
+             */
+            virtual void SetWritableDelegate(WritableDelegate writableDelegate) = 0;
+        };
+
+        /**
+         * This is the interface given to streamed request handlers through
+         * which the server delivers the body of a request incrementally,
+         * as it arrives on the connection, rather than buffering the
+         * entire body in memory before the handler runs.
+         */
+        class RequestReader {
+        public:
+            // Types
+
+            /**
+             * This is the type of function to call to deliver each piece
+             * of the request body as it arrives on the connection.
+             *
+             * @param[in] bodyData
+             *     This is the piece of the request body being delivered.
+             */
+            typedef std::function< void(const std::string& bodyData) > BodyDelegate;
+
+            /**
+             * This is the type of function to call once the entire
+             * request body has been delivered.
+             */
+            typedef std::function< void() > BodyEndDelegate;
+
+            // Methods
+
+            /**
+             * This method sets the function to call to deliver each piece
+             * of the request body as it arrives on the connection.  Any
+             * body characters already received are delivered once the
+             * function is set.
+             *
+             * @param[in] bodyDelegate
+             *     This is the function to call to deliver each piece
+             *     of the request body.
+             */
+            virtual void SetBodyDelegate(BodyDelegate bodyDelegate) = 0;
+
+            /**
+             * This method sets the function to call once the entire
+             * request body has been delivered.  If the connection is
+             * broken before that point, the abandoned delegate of the
+             * handler's ResponseWriter is called instead.
+             *
+             * @param[in] bodyEndDelegate
+             *     This is the function to call once the entire request
+             *     body has been delivered.
+             */
+            virtual void SetBodyEndDelegate(BodyEndDelegate bodyEndDelegate) = 0;
+
+            /**
+             * This method suspends delivery of the request body.  Body
+             * characters received while delivery is suspended are held
+             * by the server until Resume is called.  A handler which
+             * can't keep up with the connection, such as one writing the
+             * body out to slower storage, should use this to apply
+             * backpressure.
+             */
+            virtual void Pause() = 0;
+
+            /**
+             * This method resumes delivery of the request body after
+             * a call to Pause, delivering any body characters received
+             * in the meantime.
+             */
+            virtual void Resume() = 0;
+        };
+
+        /**
+         * This is the type of function which can be registered to handle
+         * HTTP requests as soon as their headers arrive, receiving their
+         * bodies incrementally rather than fully buffered.
+         *
+         * @param[in] request
+         *     This is the request to apply to the resource.  Its headers
+         *     are complete, but its body is empty; the body is delivered
+         *     through the given request reader instead.
+         *
+         * @param[in] requestReader
+         *     This is the object through which the body of the request
+         *     is delivered as it arrives on the connection.
+         *
+         * @param[in] responseWriter
+         *     This is the object through which to send the response back
+         *     to the client.
+         */
+        typedef std::function<
+            void(
+                const Request& request,
+                std::shared_ptr< RequestReader > requestReader,
+                std::shared_ptr< ResponseWriter > responseWriter
+            )
+        > StreamedRequestResourceDelegate;
+
+        /**
+         * This is the type of function which can be registered to handle
+         * HTTP requests by streaming their responses back to the client,
+         * rather than returning fully materialized responses.
+         *
+         * @param[in] request
+         *     This is the request to apply to the resource.
+         *
+         * @param[in] responseWriter
+         *     This is the object through which to send the response back
+         *     to the client.  The handler may hold onto it and continue
+         *     sending pieces of the response body after returning, calling
+         *     ResponseWriter::FinishResponse once the response is complete.
+         */
+        typedef std::function<
+            void(
+                const Request& request,
+                std::shared_ptr< ResponseWriter > responseWriter
+            )
+        > StreamedResourceDelegate;
+
         /**
          * This is the type of function returned by RegisterResource,
          * to be called when the resource should be unregistered
@@ -86,6 +312,104 @@ namespace Http {
             const std::string& reason
         ) > BanDelegate;
 
+        /**
+         * This holds a sampling of the counters the server keeps about
+         * the traffic it has handled.  The counters are updated with
+         * relaxed atomic operations on the server's hot paths, so a
+         * snapshot is cheap to take but may be slightly stale with
+         * respect to traffic in flight when it's taken.
+         */
+        struct MetricsSnapshot {
+            /**
+             * This is the number of client connections currently
+             * being serviced.
+             */
+            size_t activeConnections = 0;
+
+            /**
+             * This is the number of requests received and parsed.
+             */
+            size_t requestsReceived = 0;
+
+            /**
+             * This is the number of responses issued with 1xx
+             * status codes.
+             */
+            size_t responsesInformational = 0;
+
+            /**
+             * This is the number of responses issued with 2xx
+             * status codes.
+             */
+            size_t responsesSuccess = 0;
+
+            /**
+             * This is the number of responses issued with 3xx
+             * status codes.
+             */
+            size_t responsesRedirection = 0;
+
+            /**
+             * This is the number of responses issued with 4xx
+             * status codes.
+             */
+            size_t responsesClientError = 0;
+
+            /**
+             * This is the number of responses issued with 5xx
+             * status codes.
+             */
+            size_t responsesServerError = 0;
+
+            /**
+             * This is the number of requests denied because their
+             * clients exceeded the request rate limit.
+             */
+            size_t requestsRejectedTooMany = 0;
+
+            /**
+             * This is the number of requests served straight from
+             * the server's response cache, without invoking
+             * any handler.
+             */
+            size_t responseCacheHits = 0;
+
+            /**
+             * This is the number of requests which consulted the
+             * server's response cache but had to invoke their
+             * handlers anyway.
+             */
+            size_t responseCacheMisses = 0;
+
+            /**
+             * This is the number of bans the server has imposed
+             * on clients.
+             */
+            size_t bansIssued = 0;
+
+            /**
+             * This is the number of bytes received from clients.
+             */
+            size_t bytesReceived = 0;
+
+            /**
+             * This is the number of bytes sent to clients.
+             */
+            size_t bytesSent = 0;
+
+            /**
+             * This is the amount of time spent parsing requests,
+             * in seconds.
+             */
+            double parseTime = 0.0;
+
+            /**
+             * This is the amount of time spent inside resource
+             * handlers, in seconds.
+             */
+            double handlerTime = 0.0;
+        };
+
         /**
          * This method forms a new subscription to diagnostic
          * messages published by the sender.
@@ -163,6 +487,73 @@ namespace Http {
             ResourceDelegate resourceDelegate
         ) = 0;
 
+        /**
+         * This method registers the given delegate to be called in order
+         * to stream a response for any request that comes in to the server
+         * with a target URI which identifies a resource within the given
+         * resource subspace of the server.
+         *
+         * Unlike RegisterResource, the delegate doesn't return a response;
+         * it's given a ResponseWriter through which it sends the status
+         * line and headers immediately, followed by the body a piece at
+         * a time, so that the entire body never needs to be held in
+         * memory at once.
+         *
+         * @param[in] resourceSubspacePath
+         *     This identifies the subspace of resources that we want
+         *     the given delegate to be responsible for handling.
+         *
+         * @param[in] streamedResourceDelegate
+         *     This is the function to call in order to apply the given
+         *     request and stream back a response when the request
+         *     identifies a resource within the given resource subspace
+         *     of the server.
+         *
+         * @return
+         *     A function is returned which, if called, revokes
+         *     the registration of the resource delegate, so that subsequent
+         *     requests to any resource within the registered resource
+         *     substate are no longer handled by the
+         *     formerly-registered delegate.
+         */
+        virtual UnregistrationDelegate RegisterStreamedResource(
+            const std::vector< std::string >& resourceSubspacePath,
+            StreamedResourceDelegate streamedResourceDelegate
+        ) = 0;
+
+        /**
+         * This method registers the given delegate to be called as soon
+         * as the headers arrive for any request that comes in to the
+         * server with a target URI which identifies a resource within the
+         * given resource subspace of the server.
+         *
+         * Unlike RegisterResource, the delegate is called before the body
+         * of the request has been received; the body is delivered to the
+         * delegate incrementally through a RequestReader, so that the
+         * entire body never needs to be held in memory at once, and may
+         * exceed the server's maximum message size.
+         *
+         * @param[in] resourceSubspacePath
+         *     This identifies the subspace of resources that we want
+         *     the given delegate to be responsible for handling.
+         *
+         * @param[in] streamedRequestResourceDelegate
+         *     This is the function to call when a request identifying
+         *     a resource within the given resource subspace of the server
+         *     has arrived up through its headers.
+         *
+         * @return
+         *     A function is returned which, if called, revokes
+         *     the registration of the resource delegate, so that subsequent
+         *     requests to any resource within the registered resource
+         *     substate are no longer handled by the
+         *     formerly-registered delegate.
+         */
+        virtual UnregistrationDelegate RegisterStreamedRequestResource(
+            const std::vector< std::string >& resourceSubspacePath,
+            StreamedRequestResourceDelegate streamedRequestResourceDelegate
+        ) = 0;
+
         /**
          * Register a function to be called whenever an IP address is added to
          * the web server's ban list.
@@ -188,6 +579,17 @@ namespace Http {
          */
         virtual std::shared_ptr< TimeKeeper > GetTimeKeeper() = 0;
 
+        /**
+         * This method samples the counters the server keeps about the
+         * traffic it has handled.  It may be called at any time,
+         * without stopping traffic.
+         *
+         * @return
+         *     A sampling of the counters the server keeps about the
+         *     traffic it has handled is returned.
+         */
+        virtual MetricsSnapshot GetMetricsSnapshot() = 0;
+
         /**
          * Impose a ban on connections from the given peer address.
          *
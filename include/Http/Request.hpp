@@ -85,6 +85,15 @@ namespace Http {
          */
         std::string method;
 
+        /**
+         * This holds the bytes of the target of the request exactly as
+         * they appeared in the request line, when the request was parsed
+         * from a connection.  It's kept so that the target doesn't need
+         * to be re-rendered from the parsed URI, such as for diagnostic
+         * messages.
+         */
+        std::string rawTarget;
+
         /**
          * This identifies the target resource upon which to apply
          * the request.
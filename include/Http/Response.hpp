@@ -10,6 +10,7 @@
  */
 
 #include <MessageHeaders/MessageHeaders.hpp>
+#include <stddef.h>
 #include <string>
 
 namespace Http {
@@ -63,6 +64,33 @@ namespace Http {
             Error,
         };
 
+        /**
+         * This identifies a region of a file whose contents serve as
+         * the body of a response.  Carrying the body this way lets the
+         * server hand the region straight to the transport, which may
+         * be able to splice the file contents onto the connection
+         * without copying them through user space at all.
+         */
+        struct FileRegion {
+            /**
+             * This is the path to the file holding the body.  When
+             * this is empty, the response has no file region and its
+             * body, if any, is carried in the `body` property.
+             */
+            std::string path;
+
+            /**
+             * This is the offset, in bytes, into the file at which
+             * the body begins.
+             */
+            size_t offset = 0;
+
+            /**
+             * This is the size of the body, in bytes.
+             */
+            size_t length = 0;
+        };
+
         // Properties
 
         /**
@@ -94,6 +122,13 @@ namespace Http {
          */
         std::string body;
 
+        /**
+         * When its path is not empty, this identifies the region of a
+         * file whose contents serve as the body of the response,
+         * instead of the `body` property.
+         */
+        FileRegion fileBody;
+
         /**
          * This indicates whether or not the response
          * passed all validity checks when it was parsed,
@@ -127,6 +162,19 @@ namespace Http {
          *     this response to the client is returned.
          */
         std::string Generate() const;
+
+        /**
+         * This method generates the status line and headers of the
+         * response into the given buffer, reusing any storage the buffer
+         * already has.  The body is not included; it's expected to be
+         * transmitted separately, such as through a vectored send, so that
+         * the body bytes don't need to be copied at all.
+         *
+         * @param[out] head
+         *     This is the buffer into which to generate the status line
+         *     and headers of the response.
+         */
+        void GenerateTo(std::string& head) const;
     };
 
 }
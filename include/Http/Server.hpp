@@ -23,6 +23,7 @@
 #include <SystemAbstractions/DiagnosticsSender.hpp>
 #include <Timekeeping/Scheduler.hpp>
 #include <Uri/Uri.hpp>
+#include <vector>
 
 namespace Http {
 
@@ -52,6 +53,16 @@ namespace Http {
              */
             std::shared_ptr< ServerTransport > transport;
 
+            /**
+             * These are any additional transport layer implementations
+             * to use alongside the first.  Each is bound to the same
+             * port as the first (as with SO_REUSEPORT), so that new
+             * connections can be accepted in parallel across several
+             * acceptors, rather than being serialized through one.
+             * This may be left empty.
+             */
+            std::vector< std::shared_ptr< ServerTransport > > transports;
+
             /**
              * This is the object used to track time in the server.
              */
@@ -176,10 +187,19 @@ namespace Http {
             const std::vector< std::string >& resourceSubspacePath,
             ResourceDelegate resourceDelegate
         ) override;
+        virtual UnregistrationDelegate RegisterStreamedResource(
+            const std::vector< std::string >& resourceSubspacePath,
+            StreamedResourceDelegate streamedResourceDelegate
+        ) override;
+        virtual UnregistrationDelegate RegisterStreamedRequestResource(
+            const std::vector< std::string >& resourceSubspacePath,
+            StreamedRequestResourceDelegate streamedRequestResourceDelegate
+        ) override;
         virtual UnregistrationDelegate RegisterBanDelegate(
             BanDelegate banDelegate
         ) override;
         virtual std::shared_ptr< TimeKeeper > GetTimeKeeper() override;
+        virtual MetricsSnapshot GetMetricsSnapshot() override;
         virtual void Ban(
             const std::string& peerAddress,
             const std::string& reason
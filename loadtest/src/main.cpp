@@ -0,0 +1,580 @@
+/**
+ * @file main.cpp
+ *
+ * This module holds the main() function of HttpLoadTest, an in-process
+ * load-generation harness for the Http::Server class.  It wires the
+ * server to a loopback transport, drives it from a configurable number
+ * of worker threads with configurable keep-alive, churn, request mix,
+ * and pipelining depth, and reports throughput along with latency
+ * percentiles, so that performance changes to the server can be
+ * quantified without real sockets or a separate load generator.
+ *
+ * © 2018 by Richard Walters
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <Http/Connection.hpp>
+#include <Http/Server.hpp>
+#include <Http/ServerTransport.hpp>
+#include <inttypes.h>
+#include <memory>
+#include <mutex>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <StringExtensions/StringExtensions.hpp>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    /**
+     * This holds the knobs of one load-test run, as gathered from the
+     * command line.
+     */
+    struct Configuration {
+        /**
+         * This is the number of worker threads, each driving its own
+         * connection to the server.
+         */
+        size_t connections = 1;
+
+        /**
+         * This is how long to drive load, in seconds.
+         */
+        double duration = 5.0;
+
+        /**
+         * This is the number of requests to concatenate into each
+         * delivery to the server, exercising its request pipelining.
+         */
+        size_t pipelineDepth = 1;
+
+        /**
+         * This is the number of requests to issue on a connection
+         * before closing it and opening a fresh one, exercising the
+         * server's accept path.  Zero means connections are kept
+         * alive for the whole run.
+         */
+        size_t requestsPerConnection = 0;
+
+        /**
+         * This is the size, in bytes, of the body the registered
+         * resource hands back.
+         */
+        size_t responseBodySize = 1024;
+
+        /**
+         * Out of every hundred requests, this many target an
+         * unregistered resource, exercising the server's 404 path.
+         */
+        size_t missPercent = 0;
+    };
+
+    /**
+     * This is the transport interface the server binds; it just hands
+     * the connection-ready delegate back to the harness so the workers
+     * can establish loopback connections directly.
+     */
+    struct LoopbackTransport
+        : public Http::ServerTransport
+    {
+        // Properties
+
+        /**
+         * This is the delegate to call whenever a new connection
+         * has been established for the server.
+         */
+        NewConnectionDelegate newConnectionDelegate;
+
+        // Http::ServerTransport
+
+        virtual bool BindNetwork(
+            uint16_t port,
+            NewConnectionDelegate newConnectionDelegate
+        ) override {
+            this->newConnectionDelegate = newConnectionDelegate;
+            return true;
+        }
+
+        virtual uint16_t GetBoundPort() override {
+            return 1234;
+        }
+
+        virtual void ReleaseNetwork() override {
+        }
+    };
+
+    /**
+     * This is one loopback connection to the server.  Requests are
+     * pushed in through the server's data-received delegate, and the
+     * responses the server sends back are counted and sized as they
+     * arrive, which for this in-process transport is before the
+     * delivery call returns.
+     */
+    struct LoopbackConnection
+        : public Http::Connection
+    {
+        // Properties
+
+        /**
+         * This is the address the connection reports for its peer.
+         * Workers are given distinct addresses so that each lands in
+         * its own client dossier and connection shard.
+         */
+        std::string peerAddress;
+
+        /**
+         * This is the delegate to call whenever data is received from
+         * the remote peer.
+         */
+        DataReceivedDelegate dataReceivedDelegate;
+
+        /**
+         * This is the delegate to call whenever the connection
+         * has been broken.
+         */
+        BrokenDelegate brokenDelegate;
+
+        /**
+         * This is the number of responses the server has sent back on
+         * the connection, counted by their status lines.
+         */
+        size_t responsesReceived = 0;
+
+        /**
+         * This is the total number of response bytes the server has
+         * sent back on the connection.
+         */
+        uintmax_t bytesReceived = 0;
+
+        /**
+         * This flag is set if the server breaks the connection.
+         */
+        bool broken = false;
+
+        // Http::Connection
+
+        virtual std::string GetPeerAddress() override {
+            return peerAddress;
+        }
+
+        virtual std::string GetPeerId() override {
+            return peerAddress + ":5555";
+        }
+
+        virtual void SetDataReceivedDelegate(DataReceivedDelegate newDataReceivedDelegate) override {
+            dataReceivedDelegate = newDataReceivedDelegate;
+        }
+
+        virtual void SetBrokenDelegate(BrokenDelegate newBrokenDelegate) override {
+            brokenDelegate = newBrokenDelegate;
+        }
+
+        virtual void SendData(const std::vector< uint8_t >& data) override {
+            bytesReceived += data.size();
+            static const std::string statusLinePrefix = "HTTP/1.1 ";
+            auto it = data.begin();
+            for (;;) {
+                it = std::search(
+                    it,
+                    data.end(),
+                    statusLinePrefix.begin(),
+                    statusLinePrefix.end()
+                );
+                if (it == data.end()) {
+                    break;
+                }
+                ++responsesReceived;
+                it += statusLinePrefix.length();
+            }
+        }
+
+        virtual void Break(bool clean) override {
+            broken = true;
+        }
+    };
+
+    /**
+     * This is the time-keeper the server is given; it reports real
+     * elapsed time so that the server's timers and rate limiters
+     * behave as they would in production.
+     */
+    struct SteadyClockTimeKeeper
+        : public Http::TimeKeeper
+    {
+        // Properties
+
+        /**
+         * This is the point in time against which elapsed time
+         * is measured.
+         */
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+        // Http::TimeKeeper
+
+        virtual double GetCurrentTime() override {
+            return std::chrono::duration< double >(
+                std::chrono::steady_clock::now() - start
+            ).count();
+        }
+    };
+
+    /**
+     * This holds what one worker thread measured during the run.
+     */
+    struct WorkerReport {
+        /**
+         * This is the number of requests the worker completed.
+         */
+        uintmax_t requestsCompleted = 0;
+
+        /**
+         * This is the total number of response bytes the worker
+         * received.
+         */
+        uintmax_t bytesReceived = 0;
+
+        /**
+         * These are the measured request latencies, in microseconds.
+         * For pipelined deliveries the latency of the whole batch is
+         * attributed to each request in it, since that's what a real
+         * pipelining client would experience.
+         */
+        std::vector< uint32_t > latenciesMicroseconds;
+    };
+
+    /**
+     * This function runs one worker thread: it opens a loopback
+     * connection to the server, delivers batches of requests until
+     * time runs out, and records latencies as it goes.
+     *
+     * @param[in] configuration
+     *     These are the knobs of the load-test run.
+     *
+     * @param[in] transport
+     *     This is the transport through which to establish
+     *     connections to the server.
+     *
+     * @param[in] workerIndex
+     *     This distinguishes the worker, giving it its own peer
+     *     address.
+     *
+     * @param[in,out] report
+     *     This is where the worker records what it measured.
+     */
+    void DriveLoad(
+        const Configuration& configuration,
+        std::shared_ptr< LoopbackTransport > transport,
+        size_t workerIndex,
+        WorkerReport& report
+    ) {
+        const auto openConnection = [&]{
+            auto connection = std::make_shared< LoopbackConnection >();
+            connection->peerAddress = StringExtensions::sprintf(
+                "load-client-%zu",
+                workerIndex
+            );
+            const auto connectionReady = transport->newConnectionDelegate(connection);
+            if (connectionReady != nullptr) {
+                connectionReady();
+            }
+            return connection;
+        };
+        const std::string hitRequest(
+            "GET /load HTTP/1.1\r\n"
+            "Host: www.example.com\r\n"
+            "\r\n"
+        );
+        const std::string missRequest(
+            "GET /no/such/resource HTTP/1.1\r\n"
+            "Host: www.example.com\r\n"
+            "\r\n"
+        );
+        auto connection = openConnection();
+        size_t requestsOnConnection = 0;
+        size_t requestsIssued = 0;
+        const auto deadline = (
+            std::chrono::steady_clock::now()
+            + std::chrono::duration_cast< std::chrono::steady_clock::duration >(
+                std::chrono::duration< double >(configuration.duration)
+            )
+        );
+        while (std::chrono::steady_clock::now() < deadline) {
+            if (connection->dataReceivedDelegate == nullptr) {
+                break;
+            }
+            std::string batch;
+            for (size_t i = 0; i < configuration.pipelineDepth; ++i) {
+                const bool miss = (
+                    (configuration.missPercent != 0)
+                    && ((requestsIssued + i) % 100 < configuration.missPercent)
+                );
+                batch += (miss ? missRequest : hitRequest);
+            }
+            const auto responsesBefore = connection->responsesReceived;
+            const auto batchStart = std::chrono::steady_clock::now();
+            connection->dataReceivedDelegate(
+                std::vector< uint8_t >(batch.begin(), batch.end())
+            );
+            const auto batchLatency = (uint32_t)std::chrono::duration_cast<
+                std::chrono::microseconds
+            >(std::chrono::steady_clock::now() - batchStart).count();
+            const auto responsesInBatch = (
+                connection->responsesReceived - responsesBefore
+            );
+            for (size_t i = 0; i < responsesInBatch; ++i) {
+                report.latenciesMicroseconds.push_back(batchLatency);
+            }
+            report.requestsCompleted += responsesInBatch;
+            requestsIssued += configuration.pipelineDepth;
+            requestsOnConnection += configuration.pipelineDepth;
+            if (
+                connection->broken
+                || (
+                    (configuration.requestsPerConnection != 0)
+                    && (requestsOnConnection >= configuration.requestsPerConnection)
+                )
+            ) {
+                report.bytesReceived += connection->bytesReceived;
+                if (
+                    !connection->broken
+                    && (connection->brokenDelegate != nullptr)
+                ) {
+                    connection->brokenDelegate(true);
+                }
+                connection = openConnection();
+                requestsOnConnection = 0;
+            }
+        }
+        report.bytesReceived += connection->bytesReceived;
+    }
+
+    /**
+     * This function picks the latency at the given percentile out of
+     * the given latencies, which must be sorted.
+     *
+     * @param[in] sortedLatencies
+     *     These are the measured latencies, sorted ascending.
+     *
+     * @param[in] percentile
+     *     This is the percentile to pick, from 0 to 100.
+     *
+     * @return
+     *     The latency at the given percentile is returned.
+     */
+    uint32_t LatencyPercentile(
+        const std::vector< uint32_t >& sortedLatencies,
+        double percentile
+    ) {
+        if (sortedLatencies.empty()) {
+            return 0;
+        }
+        auto index = (size_t)(
+            (percentile / 100.0)
+            * (double)sortedLatencies.size()
+        );
+        index = std::min(index, sortedLatencies.size() - 1);
+        return sortedLatencies[index];
+    }
+
+    /**
+     * This function prints how to invoke the harness.
+     */
+    void PrintUsage() {
+        fprintf(
+            stderr,
+            (
+                "usage: HttpLoadTest [options]\n"
+                "\n"
+                "options:\n"
+                "  --connections N              worker threads, one connection each (default: 1)\n"
+                "  --duration S                 seconds to drive load (default: 5.0)\n"
+                "  --pipeline D                 requests per delivery to the server (default: 1)\n"
+                "  --requests-per-connection K  requests before reconnecting; 0 keeps\n"
+                "                               connections alive for the whole run (default: 0)\n"
+                "  --response-body-size B       bytes in the registered resource's body\n"
+                "                               (default: 1024)\n"
+                "  --miss-percent P             percent of requests sent to an unregistered\n"
+                "                               resource (default: 0)\n"
+            )
+        );
+    }
+
+}
+
+/**
+ * This function is the entrypoint of the program.
+ *
+ * @param[in] argc
+ *     This is the number of command-line arguments given to the program.
+ *
+ * @param[in] argv
+ *     This is the array of command-line arguments given to the program.
+ */
+int main(int argc, char* argv[]) {
+    Configuration configuration;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const auto nextArg = [&]() -> const char* {
+            if (i + 1 >= argc) {
+                PrintUsage();
+                exit(EXIT_FAILURE);
+            }
+            return argv[++i];
+        };
+        if (arg == "--connections") {
+            if (sscanf(nextArg(), "%zu", &configuration.connections) != 1) {
+                PrintUsage();
+                return EXIT_FAILURE;
+            }
+        } else if (arg == "--duration") {
+            if (sscanf(nextArg(), "%lf", &configuration.duration) != 1) {
+                PrintUsage();
+                return EXIT_FAILURE;
+            }
+        } else if (arg == "--pipeline") {
+            if (sscanf(nextArg(), "%zu", &configuration.pipelineDepth) != 1) {
+                PrintUsage();
+                return EXIT_FAILURE;
+            }
+        } else if (arg == "--requests-per-connection") {
+            if (sscanf(nextArg(), "%zu", &configuration.requestsPerConnection) != 1) {
+                PrintUsage();
+                return EXIT_FAILURE;
+            }
+        } else if (arg == "--response-body-size") {
+            if (sscanf(nextArg(), "%zu", &configuration.responseBodySize) != 1) {
+                PrintUsage();
+                return EXIT_FAILURE;
+            }
+        } else if (arg == "--miss-percent") {
+            if (sscanf(nextArg(), "%zu", &configuration.missPercent) != 1) {
+                PrintUsage();
+                return EXIT_FAILURE;
+            }
+        } else {
+            PrintUsage();
+            return EXIT_FAILURE;
+        }
+    }
+    if (
+        (configuration.connections == 0)
+        || (configuration.pipelineDepth == 0)
+        || (configuration.duration <= 0.0)
+        || (configuration.missPercent > 100)
+    ) {
+        PrintUsage();
+        return EXIT_FAILURE;
+    }
+
+    // Set up the server on a loopback transport, with the workers'
+    // addresses acceptlisted so that the rate limiters don't get the
+    // harness banned; it's meant to measure the request path, not the
+    // ban hammer.
+    Http::Server server;
+    const auto transport = std::make_shared< LoopbackTransport >();
+    Http::Server::MobilizationDependencies deps;
+    deps.transport = transport;
+    deps.timeKeeper = std::make_shared< SteadyClockTimeKeeper >();
+    for (size_t i = 0; i < configuration.connections; ++i) {
+        server.AcceptlistAdd(
+            StringExtensions::sprintf("load-client-%zu", i)
+        );
+    }
+    if (!server.Mobilize(deps)) {
+        fprintf(stderr, "HttpLoadTest: unable to mobilize server\n");
+        return EXIT_FAILURE;
+    }
+    const std::string responseBody(configuration.responseBodySize, 'X');
+    const auto unregister = server.RegisterResource(
+        {"load"},
+        [&responseBody](
+            const Http::Request& request,
+            std::shared_ptr< Http::Connection > connection,
+            const std::string& trailer
+        ){
+            Http::Response response;
+            response.statusCode = 200;
+            response.reasonPhrase = "OK";
+            response.headers.SetHeader("Content-Type", "text/plain");
+            response.body = responseBody;
+            return response;
+        }
+    );
+
+    // Drive load from the workers and wait for them all to finish.
+    printf(
+        "HttpLoadTest: %zu connection(s), pipeline depth %zu, %s, %zu%% misses, %gs\n",
+        configuration.connections,
+        configuration.pipelineDepth,
+        (
+            (configuration.requestsPerConnection == 0)
+            ? std::string("keep-alive")
+            : StringExtensions::sprintf(
+                "%zu request(s) per connection",
+                configuration.requestsPerConnection
+            )
+        ).c_str(),
+        configuration.missPercent,
+        configuration.duration
+    );
+    std::vector< WorkerReport > reports(configuration.connections);
+    std::vector< std::thread > workers;
+    workers.reserve(configuration.connections);
+    const auto runStart = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < configuration.connections; ++i) {
+        workers.emplace_back(
+            DriveLoad,
+            std::ref(configuration),
+            transport,
+            i,
+            std::ref(reports[i])
+        );
+    }
+    for (auto& worker: workers) {
+        worker.join();
+    }
+    const auto elapsed = std::chrono::duration< double >(
+        std::chrono::steady_clock::now() - runStart
+    ).count();
+    unregister();
+
+    // Merge what the workers measured and report the run.
+    uintmax_t requestsCompleted = 0;
+    uintmax_t bytesReceived = 0;
+    std::vector< uint32_t > latencies;
+    for (const auto& report: reports) {
+        requestsCompleted += report.requestsCompleted;
+        bytesReceived += report.bytesReceived;
+        latencies.insert(
+            latencies.end(),
+            report.latenciesMicroseconds.begin(),
+            report.latenciesMicroseconds.end()
+        );
+    }
+    std::sort(latencies.begin(), latencies.end());
+    printf(
+        "requests:   %" PRIuMAX " in %.3lfs (%.0lf requests/sec)\n",
+        requestsCompleted,
+        elapsed,
+        (double)requestsCompleted / elapsed
+    );
+    printf(
+        "throughput: %.2lf MB/sec received\n",
+        (double)bytesReceived / elapsed / 1048576.0
+    );
+    printf(
+        "latency:    p50 %" PRIu32 "us  p90 %" PRIu32 "us  p99 %" PRIu32 "us"
+        "  p99.9 %" PRIu32 "us  max %" PRIu32 "us\n",
+        LatencyPercentile(latencies, 50.0),
+        LatencyPercentile(latencies, 90.0),
+        LatencyPercentile(latencies, 99.0),
+        LatencyPercentile(latencies, 99.9),
+        (latencies.empty() ? 0 : latencies.back())
+    );
+    return EXIT_SUCCESS;
+}
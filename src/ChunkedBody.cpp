@@ -9,9 +9,11 @@
 #include <algorithm>
 #include <Http/ChunkedBody.hpp>
 #include <limits>
-#include <sstream>
+#include <ostream>
+#include <stdint.h>
 #include <stddef.h>
 #include <string>
+#include <string.h>
 
 namespace {
 
@@ -21,19 +23,55 @@ namespace {
     const std::string CRLF = "\r\n";
 
     /**
-     * These are the characters which are valid for use in tokens.
+     * This is a lookup table, indexed by character code, of flags
+     * indicating which characters are valid for use in tokens.
      */
-    const std::string TCHAR = "!#$%&'*+-.^_`|~0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ";
+    struct TcharTable {
+        /**
+         * For each character code, this flag indicates whether or not
+         * the character is valid for use in tokens.
+         */
+        bool isTchar[256];
+
+        /**
+         * This is the default constructor, which marks the characters
+         * that are valid for use in tokens.
+         */
+        TcharTable()
+            : isTchar()
+        {
+            static const std::string tchars = "!#$%&'*+-.^_`|~0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ";
+            for (auto c: tchars) {
+                isTchar[(uint8_t)c] = true;
+            }
+        }
+    };
 
     /**
-     * This is the mode flag combination to use when initializing
-     * output string streams in this module.
+     * This function determines whether or not the given character is
+     * valid for use in tokens, with a single table lookup rather than
+     * a scan through the list of valid characters.
+     *
+     * @param[in] c
+     *     This is the character to check.
+     *
+     * @return
+     *     An indication of whether or not the given character is valid
+     *     for use in tokens is returned.
      */
-    constexpr std::ios_base::openmode OUTPUT_STRING_STREAM_OPEN_MODE = (
-        std::ios_base::out          // output, of course
-        | std::ios_base::binary     // binary; don't confuse us with LF -> CRLF
-        | std::ios_base::ate        // seek to the end always when opening
-    );
+    bool IsTchar(char c) {
+        static const TcharTable tcharTable;
+        return tcharTable.isTchar[(uint8_t)c];
+    }
+
+    /**
+     * This is the most extra capacity, in bytes, to reserve in the
+     * decoded body ahead of a single chunk's data, based on the size
+     * declared in its chunk-size line.  It keeps a malicious or
+     * corrupted chunk-size line from provoking a huge allocation
+     * before any actual chunk data has arrived.
+     */
+    constexpr size_t MAX_CHUNK_DATA_RESERVATION = 16777216;
 
     /**
      * This function decodes the given line of input as a chunk-size line.
@@ -41,7 +79,7 @@ namespace {
      * Any chunk extensions are parsed but discarded.
      *
      * @param[in] input
-     *     This is the string holding the line of input.
+     *     This points to the first character of the line of input.
      *
      * @param[in] lineLength
      *     This is the length of the line of input.
@@ -54,7 +92,7 @@ namespace {
      *     successfully parsed is returned.
      */
     bool DecodeChunkSizeLine(
-        const std::string& input,
+        const char* input,
         size_t lineLength,
         size_t& chunkSize
     ) {
@@ -85,7 +123,7 @@ namespace {
                 } break;
 
                 case 1: { // chunk-ext: chunk-ext-name (first character)
-                    if (TCHAR.find(c) == std::string::npos) {
+                    if (!IsTchar(c)) {
                         return false;
                     }
                     state = 2;
@@ -96,7 +134,7 @@ namespace {
                         state = 3;
                     } else if (c == ';') {
                         state = 1;
-                    } else if (TCHAR.find(c) == std::string::npos) {
+                    } else if (!IsTchar(c)) {
                         return false;
                     }
                 } break;
@@ -104,7 +142,7 @@ namespace {
                 case 3: { // chunk-ext: chunk-ext-val (first character)
                     if (c == '"') {
                         state = 5;
-                    } else if (TCHAR.find(c) == std::string::npos) {
+                    } else if (!IsTchar(c)) {
                         return false;
                     } else {
                         state = 4;
@@ -114,7 +152,7 @@ namespace {
                 case 4: { // chunk-ext: chunk-ext-val (token, not first character)
                     if (c == ';') {
                         state = 1;
-                    } else if (TCHAR.find(c) == std::string::npos) {
+                    } else if (!IsTchar(c)) {
                         return false;
                     }
                 } break;
@@ -188,9 +226,12 @@ namespace Http {
         size_t currentChunkBytesMissing = 0;
 
         /**
-         * This contains the actual decoded body.
+         * This contains the actual decoded body.  Chunk data is
+         * appended to it directly as it's decoded, and the whole
+         * buffer may be moved out through TakeBody once the decoding
+         * is complete.
          */
-        std::ostringstream decodedBody;
+        std::string decodedBody;
 
         /**
          * This holds any trailers that were attached
@@ -199,20 +240,13 @@ namespace Http {
         MessageHeaders::MessageHeaders trailers;
 
         /**
-         * This is used to reassemble the encoded chunk before decoding it.
-         */
-        std::ostringstream reassemblyBuffer;
-
-        // Methods
-
-        /**
-         * This is the default constructor.
+         * This holds any input characters left over from the last call
+         * to Decode which couldn't be decoded yet, such as part of a
+         * chunk-size line whose line terminator hasn't arrived.  Chunk
+         * data itself is never held here; it's decoded into the body
+         * as soon as it's seen.
          */
-        Impl()
-            : decodedBody(OUTPUT_STRING_STREAM_OPEN_MODE)
-            , reassemblyBuffer(OUTPUT_STRING_STREAM_OPEN_MODE)
-        {
-        }
+        std::string reassemblyBuffer;
     };
 
     ChunkedBody::~ChunkedBody() noexcept = default;
@@ -229,85 +263,121 @@ namespace Http {
         size_t offset,
         size_t length
     ) {
-        const size_t charactersPreviouslyAccepted = (size_t)impl_->reassemblyBuffer.tellp();
         if (length == 0) {
             length = input.length();
         }
-        impl_->reassemblyBuffer << input.substr(offset, length);
+        length = std::min(length, input.length() - offset);
+
+        // Decode directly out of the given input whenever no input is
+        // left over from a previous call; otherwise, the new input has
+        // to be appended to the leftovers first, since a chunk-size
+        // line or delimiter may straddle the two.
+        const size_t charactersPreviouslyRetained = impl_->reassemblyBuffer.length();
+        const char* data;
+        size_t size;
+        if (charactersPreviouslyRetained == 0) {
+            data = input.data() + offset;
+            size = length;
+        } else {
+            impl_->reassemblyBuffer.append(input, offset, length);
+            data = impl_->reassemblyBuffer.data();
+            size = impl_->reassemblyBuffer.length();
+        }
+        size_t position = 0;
         size_t charactersAccepted = 0;
+        bool retainRemainder = false;
         while (
-            (impl_->reassemblyBuffer.tellp() > 0)
+            (position < size)
             && (impl_->state != State::Complete)
             && (impl_->state != State::Error)
         ) {
             if (impl_->state == State::DecodingChunks) {
-                const auto reassembledInput = impl_->reassemblyBuffer.str();
-                const auto lineEnd = reassembledInput.find(CRLF);
-                if (lineEnd == std::string::npos) {
-                    charactersAccepted += (size_t)impl_->reassemblyBuffer.tellp();
+                // Locate the end of the chunk-size line, if the whole
+                // line has arrived.
+                size_t lineEnd = size;
+                size_t searchPosition = position;
+                while (searchPosition + CRLF.length() <= size) {
+                    const auto cr = (const char*)memchr(
+                        data + searchPosition,
+                        '\r',
+                        size - searchPosition - 1
+                    );
+                    if (cr == NULL) {
+                        break;
+                    }
+                    searchPosition = (size_t)(cr - data);
+                    if (data[searchPosition + 1] == '\n') {
+                        lineEnd = searchPosition;
+                        break;
+                    }
+                    ++searchPosition;
+                }
+                if (lineEnd == size) {
+                    retainRemainder = true;
                     break;
                 }
-                const auto lineLength = lineEnd + CRLF.length();
+                const auto lineLength = lineEnd - position + CRLF.length();
                 charactersAccepted += lineLength;
                 if (
                     !DecodeChunkSizeLine(
-                        reassembledInput,
-                        lineEnd,
+                        data + position,
+                        lineEnd - position,
                         impl_->currentChunkBytesMissing
                     )
                 ) {
                     impl_->state = State::Error;
                     break;
                 }
-                impl_->reassemblyBuffer = std::ostringstream(reassembledInput.substr(lineLength), OUTPUT_STRING_STREAM_OPEN_MODE);
+                position += lineLength;
                 if (impl_->currentChunkBytesMissing == 0) {
                     impl_->state = State::DecodingTrailer;
                 } else {
                     impl_->state = State::ReadingChunkData;
+                    impl_->decodedBody.reserve(
+                        impl_->decodedBody.length()
+                        + std::min(
+                            impl_->currentChunkBytesMissing,
+                            MAX_CHUNK_DATA_RESERVATION
+                        )
+                    );
                 }
             }
             if (impl_->state == State::ReadingChunkData) {
-                const size_t chunkDataAvailableFromInput = (size_t)impl_->reassemblyBuffer.tellp();
                 const auto chunkDataToCopyFromInput = std::min(
-                    chunkDataAvailableFromInput,
+                    size - position,
                     impl_->currentChunkBytesMissing
                 );
                 if (chunkDataToCopyFromInput > 0) {
-                    const auto reassembledInput = impl_->reassemblyBuffer.str();
-                    if (reassembledInput.length() == chunkDataToCopyFromInput) {
-                        impl_->decodedBody << reassembledInput;
-                        impl_->reassemblyBuffer = std::ostringstream(OUTPUT_STRING_STREAM_OPEN_MODE);
-                    } else {
-                        impl_->decodedBody << reassembledInput.substr(0, chunkDataToCopyFromInput);
-                        impl_->reassemblyBuffer = std::ostringstream(reassembledInput.substr(chunkDataToCopyFromInput), OUTPUT_STRING_STREAM_OPEN_MODE);
-                    }
+                    impl_->decodedBody.append(data + position, chunkDataToCopyFromInput);
+                    position += chunkDataToCopyFromInput;
                     charactersAccepted += chunkDataToCopyFromInput;
                     impl_->currentChunkBytesMissing -= chunkDataToCopyFromInput;
-                    if (impl_->currentChunkBytesMissing == 0) {
-                        impl_->state = State::ReadingChunkDelimiter;
-                    }
+                }
+                if (impl_->currentChunkBytesMissing == 0) {
+                    impl_->state = State::ReadingChunkDelimiter;
                 }
             }
             if (impl_->state == State::ReadingChunkDelimiter) {
-                if ((size_t)impl_->reassemblyBuffer.tellp() < CRLF.length()) {
-                    charactersAccepted += (size_t)impl_->reassemblyBuffer.tellp();
+                if (size - position < CRLF.length()) {
+                    retainRemainder = true;
                     break;
                 }
-                const auto reassembledInput = impl_->reassemblyBuffer.str();
-                if (reassembledInput.substr(0, CRLF.length()) != CRLF) {
+                if (
+                    (data[position] != '\r')
+                    || (data[position + 1] != '\n')
+                ) {
                     impl_->state = State::Error;
                     break;
                 }
+                position += CRLF.length();
                 charactersAccepted += CRLF.length();
-                impl_->reassemblyBuffer = std::ostringstream(reassembledInput.substr(CRLF.length()), OUTPUT_STRING_STREAM_OPEN_MODE);
                 impl_->state = State::DecodingChunks;
             }
             if (impl_->state == State::DecodingTrailer) {
-                const auto reassembledInput = impl_->reassemblyBuffer.str();
                 size_t charactersAcceptedByTrailer;
                 switch (
                     impl_->trailers.ParseRawMessage(
-                        reassembledInput,
+                        std::string(data + position, size - position),
                         charactersAcceptedByTrailer
                     )
                 ) {
@@ -327,11 +397,24 @@ namespace Http {
                         impl_->state = State::Error;
                     } break;
                 }
-                impl_->reassemblyBuffer = std::ostringstream(OUTPUT_STRING_STREAM_OPEN_MODE);
                 charactersAccepted += charactersAcceptedByTrailer;
+                position = size;
             }
         }
-        return charactersAccepted - charactersPreviouslyAccepted;
+        if (retainRemainder) {
+            // Characters held over for the next call still count as
+            // accepted; they were counted when retained, so they're
+            // not counted again when finally decoded.
+            charactersAccepted += size - position;
+            if (charactersPreviouslyRetained == 0) {
+                impl_->reassemblyBuffer.assign(data + position, size - position);
+            } else {
+                impl_->reassemblyBuffer.erase(0, position);
+            }
+        } else {
+            impl_->reassemblyBuffer.clear();
+        }
+        return charactersAccepted - charactersPreviouslyRetained;
     }
 
     auto ChunkedBody::GetState() const -> State {
@@ -339,7 +422,11 @@ namespace Http {
     }
 
     ChunkedBody::operator std::string() const {
-        return impl_->decodedBody.str();
+        return impl_->decodedBody;
+    }
+
+    std::string ChunkedBody::TakeBody() {
+        return std::move(impl_->decodedBody);
     }
 
     const MessageHeaders::MessageHeaders& ChunkedBody::GetTrailers() const {
@@ -10,6 +10,7 @@
 
 #include <algorithm>
 #include <condition_variable>
+#include <deque>
 #include <functional>
 #include <Http/ChunkedBody.hpp>
 #include <Http/Client.hpp>
@@ -22,6 +23,7 @@
 #include <mutex>
 #include <set>
 #include <string>
+#include <string.h>
 #include <sstream>
 #include <StringExtensions/StringExtensions.hpp>
 #include <SystemAbstractions/DiagnosticsSender.hpp>
@@ -43,12 +45,6 @@ namespace {
      */
     constexpr uint16_t DEFAULT_HTTP_PORT_NUMBER = 80;
 
-    /**
-     * This is the number of milliseconds to wait between rounds of polling
-     * connections to check for timeouts.
-     */
-    constexpr unsigned int CONNECTION_POLLING_PERIOD_MILLISECONDS = 50;
-
     /**
      * This is a temporary wrapper to adapt the Http::TimeKeeper interface
      * to the Timekeeping::Clock interface.  It will be removed once the
@@ -135,16 +131,48 @@ namespace {
         "Trailer",
     };
 
+    /**
+     * This function determines whether or not the given request method
+     * is idempotent, as defined by RFC 7231 section 4.2.2.  Only
+     * requests with idempotent methods are safe to pipeline, since they
+     * may need to be sent again if the connection is lost before their
+     * responses arrive.
+     *
+     * @param[in] method
+     *     This is the request method to check.
+     *
+     * @return
+     *     An indication of whether or not the given request method
+     *     is idempotent is returned.
+     */
+    bool IsIdempotentMethod(const std::string& method) {
+        static const std::set< std::string > idempotentMethods{
+            "GET",
+            "HEAD",
+            "PUT",
+            "DELETE",
+            "OPTIONS",
+            "TRACE",
+        };
+        return idempotentMethods.find(method) != idempotentMethods.end();
+    }
+
     /**
      * This method parses the protocol identifier, status code,
-     * and reason phrase from the given status line.
+     * and reason phrase from the given status line.  The status line is
+     * given as a span of the caller's buffer, so that no intermediate
+     * copy of it needs to be made.
      *
      * @param[in] response
      *     This is the response in which to store the parsed
      *     status code and reason phrase.
      *
      * @param[in] statusLine
-     *     This is the raw status line string to parse.
+     *     This points to the first character of the raw status line.
+     *
+     * @param[in] statusLineLength
+     *     This is the number of characters in the raw status line,
+     *     not including the line terminator.
      *
      * @return
      *     An indication of whether or not the status line
@@ -152,30 +180,32 @@ namespace {
      */
     bool ParseStatusLine(
         Http::Response& response,
-        const std::string& statusLine
+        const char* statusLine,
+        size_t statusLineLength
     ) {
         // Parse the protocol.
-        const auto protocolDelimiter = statusLine.find(' ');
-        if (protocolDelimiter == std::string::npos) {
+        const auto statusLineEnd = statusLine + statusLineLength;
+        const auto protocolDelimiter = std::find(statusLine, statusLineEnd, ' ');
+        if (protocolDelimiter == statusLineEnd) {
             return false;
         }
-        const auto protocol = statusLine.substr(0, protocolDelimiter);
-        if (protocol != "HTTP/1.1") {
+        if (
+            ((protocolDelimiter - statusLine) != 8)
+            || (memcmp(statusLine, "HTTP/1.1", 8) != 0)
+        ) {
             return false;
         }
 
         // Parse the status code.
-        const auto statusCodeDelimiter = statusLine.find(' ', protocolDelimiter + 1);
-        if (statusCodeDelimiter == std::string::npos) {
+        const auto statusCodeStart = protocolDelimiter + 1;
+        const auto statusCodeDelimiter = std::find(statusCodeStart, statusLineEnd, ' ');
+        if (statusCodeDelimiter == statusLineEnd) {
             return false;
         }
         intmax_t statusCodeAsInt;
         if (
             StringExtensions::ToInteger(
-                statusLine.substr(
-                    protocolDelimiter + 1,
-                    statusCodeDelimiter - protocolDelimiter - 1
-                ),
+                std::string(statusCodeStart, statusCodeDelimiter),
                 statusCodeAsInt
             ) != StringExtensions::ToIntegerResult::Success
         ) {
@@ -188,7 +218,7 @@ namespace {
         }
 
         // Parse the reason phrase.
-        response.reasonPhrase = statusLine.substr(statusCodeDelimiter + 1);
+        response.reasonPhrase.assign(statusCodeDelimiter + 1, statusLineEnd);
         return true;
     }
 
@@ -240,17 +270,45 @@ namespace {
             if (statusLineEnd == std::string::npos) {
                 return messageEnd;
             }
-            const auto statusLine = nextRawResponsePart.substr(0, statusLineEnd);
             messageEnd = statusLineEnd + CRLF.length();
             response.state = Http::Response::State::Headers;
-            response.valid = ParseStatusLine(response, statusLine);
+            response.valid = ParseStatusLine(
+                response,
+                nextRawResponsePart.data(),
+                statusLineEnd
+            );
         }
 
         // Second, parse the message headers and identify where the body begins.
+        //
+        // MessageHeaders requires its input in a contiguous string, so
+        // the unparsed headers are the one part of the message which still
+        // has to be copied out of the reassembly buffer.  Limit the copy to
+        // the end of the headers, if it's in view, so that any body
+        // characters already received aren't dragged along with it.
         if (response.state == Http::Response::State::Headers) {
+            const auto headersBegin = nextRawResponsePart.data() + messageEnd;
+            auto headersLength = nextRawResponsePart.length() - messageEnd;
+            if (
+                (headersLength >= CRLF.length())
+                && (memcmp(headersBegin, CRLF.data(), CRLF.length()) == 0)
+            ) {
+                headersLength = CRLF.length();
+            } else {
+                static const std::string doubleCRLF("\r\n\r\n");
+                const auto headersEnd = std::search(
+                    headersBegin,
+                    headersBegin + headersLength,
+                    doubleCRLF.begin(),
+                    doubleCRLF.end()
+                );
+                if (headersEnd != headersBegin + headersLength) {
+                    headersLength = (size_t)(headersEnd - headersBegin) + doubleCRLF.length();
+                }
+            }
             size_t bodyOffset;
             const auto headersState = response.headers.ParseRawMessage(
-                nextRawResponsePart.substr(messageEnd),
+                std::string(headersBegin, headersLength),
                 bodyOffset
             );
             messageEnd += bodyOffset;
@@ -300,7 +358,10 @@ namespace {
                         response.state = Http::Response::State::Body;
                         return messageEnd;
                     } else {
-                        response.body = nextRawResponsePart.substr(messageEnd, contentLength);
+                        response.body.assign(
+                            nextRawResponsePart.data() + messageEnd,
+                            contentLength
+                        );
                         messageEnd += contentLength;
                         response.state = Http::Response::State::Complete;
                     }
@@ -309,7 +370,7 @@ namespace {
                 messageEnd += chunkedBody.Decode(nextRawResponsePart, messageEnd);
                 switch (chunkedBody.GetState()) {
                     case Http::ChunkedBody::State::Complete: {
-                        response.body = chunkedBody;
+                        response.body = chunkedBody.TakeBody();
                         for (const auto& trailer: chunkedBody.GetTrailers().GetAll()) {
                             if (HEADERS_NOT_ALLOWED_IN_TRAILER.find(trailer.name) == HEADERS_NOT_ALLOWED_IN_TRAILER.end()) {
                                 response.headers.AddHeader(trailer.name, trailer.value);
@@ -346,7 +407,10 @@ namespace {
                     } break;
                 }
             } else if (response.headers.HasHeaderToken("Connection", "close")) {
-                response.body += nextRawResponsePart.substr(messageEnd);
+                response.body.append(
+                    nextRawResponsePart.data() + messageEnd,
+                    bytesAvailableForBody
+                );
                 messageEnd += bytesAvailableForBody;
             } else {
                 response.body.clear();
@@ -429,6 +493,24 @@ namespace {
          */
         std::weak_ptr< struct TransactionImpl > currentTransaction;
 
+        /**
+         * These are the transactions whose requests have been pipelined
+         * on this connection behind the current transaction's request,
+         * oldest first.  Their responses are owed in this same order,
+         * each one taking over as the current transaction when the
+         * response before it completes.
+         */
+        std::deque< std::weak_ptr< struct TransactionImpl > > pipeline;
+
+        /**
+         * This flag indicates whether or not every request in flight on
+         * this connection used an idempotent method.  Only then may
+         * another request be pipelined behind them, since requests
+         * still in the pipeline when the connection is lost are sent
+         * again through other connections.
+         */
+        bool inFlightIdempotent = false;
+
         /**
          * This is the function to call to schedule the connection to
          * be dropped if it remains inactive for too long past the
@@ -507,6 +589,42 @@ namespace {
          */
         std::string reassemblyBuffer;
 
+        /**
+         * This is the exact serialization of the request as it was
+         * sent to the server.  It's only kept for pipelined requests,
+         * so that the request can be sent again through another
+         * connection if this one is lost while the request is still
+         * waiting in the pipeline.
+         */
+        std::string serializedRequest;
+
+        /**
+         * This is the scheme indicated in the URI of the target of the
+         * request, kept in case the request has to be sent again
+         * through a new connection.
+         */
+        std::string scheme;
+
+        /**
+         * This is the unique identifier of the server, in the form
+         * "host:port", kept in case the request has to be sent again
+         * through a new connection.
+         */
+        std::string serverId;
+
+        /**
+         * This is the host name, or IP address in string form, of the
+         * server, kept in case the request has to be sent again
+         * through a new connection.
+         */
+        std::string hostNameOrAddress;
+
+        /**
+         * This is the TCP port number of the server, kept in case the
+         * request has to be sent again through a new connection.
+         */
+        uint16_t port = DEFAULT_HTTP_PORT_NUMBER;
+
         /**
          * This is used to synchronize access to the object.
          */
@@ -523,6 +641,13 @@ namespace {
          */
         std::function< void() > completionDelegate;
 
+        /**
+         * If set, this is a function to call once the transaction is
+         * completed, in order to cancel the callback scheduled to time
+         * out the transaction.
+         */
+        std::function< void() > cancelReceiveTimeout;
+
         // Methods
 
         /**
@@ -580,13 +705,31 @@ namespace {
                     connectionState->connection->Break(false);
                 }
                 connectionState->currentTransaction.reset();
-                if (connectionState->setInactivityTimeout != nullptr) {
-                    connectionState->setInactivityTimeout();
+                if (
+                    !dropConnection
+                    && persistConnection
+                    && (state == State::Completed)
+                    && !connectionState->broken
+                    && !connectionState->pipeline.empty()
+                ) {
+                    // The next pipelined transaction takes over receiving
+                    // on the connection; its response follows ours.
+                    connectionState->currentTransaction = connectionState->pipeline.front();
+                    connectionState->pipeline.pop_front();
+                } else if (connectionState->pipeline.empty()) {
+                    connectionState->inFlightIdempotent = false;
+                    if (connectionState->setInactivityTimeout != nullptr) {
+                        connectionState->setInactivityTimeout();
+                    }
                 }
             }
             stateChange.notify_all();
             auto completionDelegateCopy = completionDelegate;
+            auto cancelReceiveTimeoutCopy = cancelReceiveTimeout;
             lock.unlock();
+            if (cancelReceiveTimeoutCopy != nullptr) {
+                cancelReceiveTimeoutCopy();
+            }
             if (completionDelegateCopy != nullptr) {
                 completionDelegateCopy();
             }
@@ -657,6 +800,34 @@ namespace {
             (void)Complete(endState, now);
         }
 
+        /**
+         * This method returns an indication of whether or not the
+         * transaction is complete.
+         *
+         * @return
+         *     An indication of whether or not the transaction is
+         *     complete is returned.
+         */
+        bool IsCompleted() {
+            std::lock_guard< decltype(mutex) > lock(mutex);
+            return complete;
+        }
+
+        /**
+         * This method moves out any input received from the server
+         * beyond the end of this transaction's response, so that it can
+         * be handed to the next transaction pipelined on the same
+         * connection.
+         *
+         * @return
+         *     Any input received beyond the end of this transaction's
+         *     response is returned.
+         */
+        std::string TakeReassemblyRemainder() {
+            std::lock_guard< decltype(mutex) > lock(mutex);
+            return std::move(reassemblyBuffer);
+        }
+
         // Http::Client::Transaction
 
         virtual bool AwaitCompletion(
@@ -762,9 +933,82 @@ namespace {
             return nullptr;
         }
 
+        /**
+         * This method attempts to find a connection in the pool whose
+         * current transaction is for an idempotent request and whose
+         * pipeline isn't full.  If one is found, the given transaction is
+         * queued behind the transactions already in flight on it, the
+         * given serialization of the request is sent through it, and the
+         * connection is returned.  Otherwise, nullptr is returned.
+         *
+         * @param[in] serverId
+         *     This is a unique identifier of the server for which a connection
+         *     is needed, in the form "host:port".
+         *
+         * @param[in] transaction
+         *     This is the transaction to pipeline on a busy connection,
+         *     if one is found.
+         *
+         * @param[in] maxPipelineDepth
+         *     This is the maximum number of requests that may be in flight
+         *     on any one connection at the same time.
+         *
+         * @param[in] serializedRequest
+         *     This is the serialization of the request to send through
+         *     the connection, if one is found.
+         *
+         * @return
+         *     If the given transaction was successfully pipelined on a
+         *     connection, the connection is returned.
+         *
+         * @retval nullptr
+         *     This is returned if no suitable connection could be found
+         *     for the transaction.
+         */
+        std::shared_ptr< ClientConnectionState > AttachPipelinedTransaction(
+            const std::string& serverId,
+            std::shared_ptr< TransactionImpl > transaction,
+            size_t maxPipelineDepth,
+            const std::string& serializedRequest
+        ) {
+            std::unique_lock< decltype(mutex) > poolLock(mutex);
+            const auto connectionsEntry = connections.find(serverId);
+            if (connectionsEntry == connections.end()) {
+                return nullptr;
+            }
+            for (const auto& connection: connectionsEntry->second) {
+                std::unique_lock< decltype(connection->mutex) > connectionLock(connection->mutex);
+                if (
+                    connection->broken
+                    || !connection->inFlightIdempotent
+                    || (connection->currentTransaction.lock() == nullptr)
+                    || (connection->pipeline.size() + 1 >= maxPipelineDepth)
+                ) {
+                    continue;
+                }
+                connection->pipeline.push_back(transaction);
+                transaction->connectionState = connection;
+                // The request is sent while still holding the connection's
+                // mutex, so that requests go out on the wire in the same
+                // order they were queued in the pipeline.  The pool's own
+                // mutex is released first, in case the transport delivers
+                // the response synchronously and the completion path
+                // re-enters the pool.
+                poolLock.unlock();
+                connection->connection->SendData(
+                    std::vector< uint8_t >(
+                        serializedRequest.begin(),
+                        serializedRequest.end()
+                    )
+                );
+                return connection;
+            }
+            return nullptr;
+        }
+
         /**
          * This method adds the given connection to the pool, if it isn't
-         * broken.
+         * broken and the pool for the server isn't already full.
          *
          * @param[in] serverId
          *     This is a unique identifier of the server end of the connection,
@@ -772,16 +1016,35 @@ namespace {
          *
          * @param[in] connection
          *     This is the connection to add to the pool.
+         *
+         * @param[in] maxConnectionsPerServer
+         *     This is the maximum number of connections the pool may
+         *     hold for any one server, or zero if there is no limit.
+         *
+         * @return
+         *     An indication of whether or not the connection was added
+         *     to the pool is returned.
          */
-        void AddConnection(
+        bool AddConnection(
             const std::string& serverId,
-            std::shared_ptr< ClientConnectionState > connection
+            std::shared_ptr< ClientConnectionState > connection,
+            size_t maxConnectionsPerServer
         ) {
             std::lock_guard< decltype(mutex) > poolLock(mutex);
             std::lock_guard< decltype(connection->mutex) > connectionLock(connection->mutex);
-            if (!connection->broken) {
-                (void)connections[serverId].insert(connection);
+            if (connection->broken) {
+                return false;
             }
+            auto& connectionPool = connections[serverId];
+            if (
+                (maxConnectionsPerServer != 0)
+                && (connectionPool.size() >= maxConnectionsPerServer)
+                && (connectionPool.find(connection) == connectionPool.end())
+            ) {
+                return false;
+            }
+            (void)connectionPool.insert(connection);
+            return true;
         }
 
         /**
@@ -881,6 +1144,26 @@ namespace Http {
          */
         double inactivityInterval = DEFAULT_INACTIVITY_INTERVAL_SECONDS;
 
+        /**
+         * This is the maximum number of persistent connections the
+         * client will hold open to any one server at the same time,
+         * or zero if there is no limit.
+         */
+        size_t maxConnectionsPerServer = DEFAULT_MAX_CONNECTIONS_PER_SERVER;
+
+        /**
+         * This is the maximum number of requests the client may have
+         * in flight on any one connection at the same time.
+         */
+        size_t maxPipelineDepth = DEFAULT_MAX_PIPELINE_DEPTH;
+
+        /**
+         * This is a weak reference the structure holds to itself, so that
+         * delegates can safely refer back to it after the client is
+         * destroyed.
+         */
+        std::weak_ptr< Impl > selfWeak;
+
         /**
          * This is used to hold onto persistent connections to servers.
          */
@@ -960,6 +1243,7 @@ namespace Http {
             std::weak_ptr< ClientConnectionState > connectionStateWeak(connectionState);
             std::weak_ptr< ClientConnectionPool > persistentConnectionsWeak(persistentConnections);
             auto timeKeeperRef = timeKeeper;
+            const auto implWeak = selfWeak;
             connectionState->connection = transport->Connect(
                 scheme,
                 hostNameOrAddress,
@@ -968,37 +1252,68 @@ namespace Http {
                     connectionStateWeak,
                     serverId,
                     persistentConnectionsWeak,
-                    timeKeeperRef
+                    timeKeeperRef,
+                    implWeak
                 ](const std::vector< uint8_t >& data){
                     const auto connectionState = connectionStateWeak.lock();
                     if (connectionState == nullptr) {
                         return;
                     }
-                    std::shared_ptr< TransactionImpl > transaction;
-                    {
-                        std::lock_guard< decltype(connectionState->mutex) > lock(connectionState->mutex);
-                        transaction = connectionState->currentTransaction.lock();
-                    }
-                    if (transaction == nullptr) {
-                        return;
-                    }
-                    if (
-                        transaction->DataReceived(
-                            data,
-                            timeKeeperRef->GetCurrentTime()
-                        )
-                    ) {
-                        const auto persistentConnections = persistentConnectionsWeak.lock();
-                        if (persistentConnections != nullptr) {
-                            persistentConnections->DropConnection(serverId, connectionState);
+                    std::vector< uint8_t > remainingData(data);
+                    for (;;) {
+                        std::shared_ptr< TransactionImpl > transaction;
+                        {
+                            std::lock_guard< decltype(connectionState->mutex) > lock(connectionState->mutex);
+                            transaction = connectionState->currentTransaction.lock();
+                        }
+                        if (transaction == nullptr) {
+                            return;
+                        }
+                        if (
+                            transaction->DataReceived(
+                                remainingData,
+                                timeKeeperRef->GetCurrentTime()
+                            )
+                        ) {
+                            const auto persistentConnections = persistentConnectionsWeak.lock();
+                            if (persistentConnections != nullptr) {
+                                persistentConnections->DropConnection(serverId, connectionState);
+                            }
+                            const auto impl = implWeak.lock();
+                            if (impl != nullptr) {
+                                impl->ReplayPipelinedTransactions(connectionState);
+                            }
+                            return;
                         }
+                        if (!transaction->IsCompleted()) {
+                            return;
+                        }
+                        // If the completed transaction's response didn't
+                        // consume all of the input, the remainder is the
+                        // beginning of the response to the next transaction
+                        // pipelined on the connection.
+                        const auto leftover = transaction->TakeReassemblyRemainder();
+                        std::shared_ptr< TransactionImpl > nextTransaction;
+                        {
+                            std::lock_guard< decltype(connectionState->mutex) > lock(connectionState->mutex);
+                            nextTransaction = connectionState->currentTransaction.lock();
+                        }
+                        if (
+                            (nextTransaction == nullptr)
+                            || (nextTransaction == transaction)
+                            || leftover.empty()
+                        ) {
+                            return;
+                        }
+                        remainingData.assign(leftover.begin(), leftover.end());
                     }
                 },
                 [
                     connectionStateWeak,
                     serverId,
                     persistentConnectionsWeak,
-                    timeKeeperRef
+                    timeKeeperRef,
+                    implWeak
                 ](bool){
                     const auto connectionState = connectionStateWeak.lock();
                     if (connectionState == nullptr) {
@@ -1010,20 +1325,106 @@ namespace Http {
                         transaction = connectionState->currentTransaction.lock();
                         connectionState->broken = true;
                     }
-                    if (transaction == nullptr) {
-                        return;
+                    if (transaction != nullptr) {
+                        transaction->ConnectionBroken(timeKeeperRef->GetCurrentTime());
                     }
-                    transaction->ConnectionBroken(timeKeeperRef->GetCurrentTime());
                     const auto persistentConnections = persistentConnectionsWeak.lock();
                     if (persistentConnections != nullptr) {
                         persistentConnections->DropConnection(serverId, connectionState);
                     }
+                    const auto impl = implWeak.lock();
+                    if (impl != nullptr) {
+                        impl->ReplayPipelinedTransactions(connectionState);
+                    }
                 }
             );
             connectionState->currentTransaction = transaction;
             return connectionState;
         }
 
+        /**
+         * This method finds any transactions still waiting in the pipeline
+         * of the given connection, and sends their requests again through
+         * other connections.  This is safe because only requests with
+         * idempotent methods are ever pipelined.
+         *
+         * @param[in] oldConnectionState
+         *     This is the state of the connection that was lost while
+         *     the transactions were waiting in its pipeline.
+         */
+        void ReplayPipelinedTransactions(
+            const std::shared_ptr< ClientConnectionState >& oldConnectionState
+        ) {
+            std::vector< std::shared_ptr< TransactionImpl > > orphanedTransactions;
+            {
+                std::lock_guard< decltype(oldConnectionState->mutex) > lock(oldConnectionState->mutex);
+                while (!oldConnectionState->pipeline.empty()) {
+                    const auto transaction = oldConnectionState->pipeline.front().lock();
+                    oldConnectionState->pipeline.pop_front();
+                    if (transaction != nullptr) {
+                        orphanedTransactions.push_back(transaction);
+                    }
+                }
+                oldConnectionState->inFlightIdempotent = false;
+            }
+            for (const auto& transaction: orphanedTransactions) {
+                if (
+                    (transport == nullptr)
+                    || (timeKeeper == nullptr)
+                    || (scheduler == nullptr)
+                ) {
+                    (void)transaction->Complete(
+                        Client::Transaction::State::Broken,
+                        0.0
+                    );
+                    continue;
+                }
+                const auto now = timeKeeper->GetCurrentTime();
+                bool freshConnection = false;
+                auto connectionState = persistentConnections->AttachTransaction(
+                    transaction->serverId,
+                    transaction,
+                    now,
+                    *scheduler
+                );
+                if (connectionState == nullptr) {
+                    connectionState = NewConnection(
+                        transaction,
+                        transaction->scheme,
+                        transaction->serverId,
+                        transaction->hostNameOrAddress,
+                        transaction->port
+                    );
+                    freshConnection = true;
+                }
+                transaction->connectionState = connectionState;
+                if (connectionState->connection == nullptr) {
+                    (void)transaction->Complete(
+                        Client::Transaction::State::UnableToConnect,
+                        now
+                    );
+                    continue;
+                }
+                if (freshConnection) {
+                    // The replacement connection isn't pooled, so it's
+                    // closed once the replayed transaction completes.
+                    std::lock_guard< decltype(transaction->mutex) > lock(transaction->mutex);
+                    transaction->persistConnection = false;
+                }
+                diagnosticsSender.SendDiagnosticInformationFormatted(
+                    1,
+                    "Replaying pipelined request to %s after losing its connection",
+                    transaction->serverId.c_str()
+                );
+                connectionState->connection->SendData(
+                    std::vector< uint8_t >(
+                        transaction->serializedRequest.begin(),
+                        transaction->serializedRequest.end()
+                    )
+                );
+            }
+        }
+
         /**
          * This method adds the given transaction to the collection of
          * transactions active for the client.
@@ -1046,6 +1447,7 @@ namespace Http {
     Client::Client()
         : impl_(new Impl)
     {
+        impl_->selfWeak = impl_;
     }
 
     void Client::Mobilize(const MobilizationDependencies& deps) {
@@ -1056,6 +1458,8 @@ namespace Http {
         impl_->timeKeeper = deps.timeKeeper;
         impl_->requestTimeoutSeconds = deps.requestTimeoutSeconds;
         impl_->inactivityInterval = deps.inactivityInterval;
+        impl_->maxConnectionsPerServer = deps.maxConnectionsPerServer;
+        impl_->maxPipelineDepth = deps.maxPipelineDepth;
         impl_->scheduler.reset(new Timekeeping::Scheduler);
         impl_->scheduler->SetClock(
             std::make_shared< ClockWrapper >(impl_->timeKeeper)
@@ -1127,7 +1531,23 @@ namespace Http {
             },
             impl_->timeKeeper->GetCurrentTime() + impl_->requestTimeoutSeconds
         );
-        const auto& hostNameOrAddress = request.target.GetHost();
+        std::weak_ptr< Impl > implWeakForTimeout(impl_);
+        const auto receiveTimeoutToken = transaction->receiveTimeoutToken;
+        transaction->cancelReceiveTimeout = [
+            implWeakForTimeout,
+            receiveTimeoutToken
+        ]{
+            const auto impl = implWeakForTimeout.lock();
+            if (
+                (impl == nullptr)
+                || (impl->scheduler == nullptr)
+            ) {
+                return;
+            }
+            impl->scheduler->Cancel(receiveTimeoutToken);
+        };
+        const auto hostNameOrAddress = request.target.GetHost();
+        const auto scheme = request.target.GetScheme();
         auto port = DEFAULT_HTTP_PORT_NUMBER;
         if (request.target.HasPort()) {
             port = request.target.GetPort();
@@ -1137,6 +1557,29 @@ namespace Http {
             hostNameOrAddress.c_str(),
             port
         );
+        request.headers.SetHeader("Host", hostNameOrAddress);
+        request.headers.SetHeader("Accept-Encoding", "gzip, deflate");
+        if (!request.body.empty()) {
+            request.headers.SetHeader(
+                "Content-Length",
+                StringExtensions::sprintf("%zu", request.body.length())
+            );
+        }
+        const auto originalTarget = request.target;
+        request.target = Uri::Uri();
+        request.target.SetPath(originalTarget.GetPath());
+        if (originalTarget.HasQuery()) {
+            request.target.SetQuery(originalTarget.GetQuery());
+        }
+        if (originalTarget.HasFragment()) {
+            request.target.SetFragment(originalTarget.GetFragment());
+        }
+        const bool pipelineCandidate = (
+            (impl_->maxPipelineDepth > 1)
+            && persistConnection
+            && (upgradeDelegate == nullptr)
+            && IsIdempotentMethod(request.method)
+        );
         const auto now = impl_->timeKeeper->GetCurrentTime();
         auto connectionState = impl_->persistentConnections->AttachTransaction(
             serverId,
@@ -1144,20 +1587,57 @@ namespace Http {
             now,
             *impl_->scheduler
         );
+        if (
+            (connectionState == nullptr)
+            && pipelineCandidate
+        ) {
+            // All of the server's pooled connections are busy, but since
+            // the request is idempotent, it may be pipelined behind the
+            // requests already in flight on one of them, rather than
+            // opening another connection.
+            transaction->serializedRequest = request.Generate();
+            transaction->scheme = scheme;
+            transaction->serverId = serverId;
+            transaction->hostNameOrAddress = hostNameOrAddress;
+            transaction->port = port;
+            transaction->persistConnection = true;
+            const auto pipelinedConnectionState = impl_->persistentConnections->AttachPipelinedTransaction(
+                serverId,
+                transaction,
+                impl_->maxPipelineDepth,
+                transaction->serializedRequest
+            );
+            if (pipelinedConnectionState != nullptr) {
+                impl_->AddTransaction(transaction);
+                return transaction;
+            }
+        }
         if (connectionState == nullptr) {
             connectionState = impl_->NewConnection(
                 transaction,
-                request.target.GetScheme(),
+                scheme,
                 serverId,
                 hostNameOrAddress,
                 port
             );
         }
-        if (
+        // A connection obtained for an upgrade is dropped from the pool when
+        // the upgrade completes, so it doesn't count against the limit on
+        // connections per server.
+        const bool pooled = (
             (connectionState->connection != nullptr)
             && persistConnection
-        ) {
-            impl_->persistentConnections->AddConnection(serverId, connectionState);
+            && impl_->persistentConnections->AddConnection(
+                serverId,
+                connectionState,
+                (
+                    (upgradeDelegate == nullptr)
+                    ? impl_->maxConnectionsPerServer
+                    : 0
+                )
+            )
+        );
+        if (pooled) {
             std::weak_ptr< Impl > implWeak(impl_);
             std::weak_ptr< ClientConnectionState > connectionStateWeak(connectionState);
             connectionState->setInactivityTimeout = [
@@ -1188,7 +1668,10 @@ namespace Http {
                             return;
                         }
                         std::lock_guard< decltype(connectionState->mutex) > connectionLock(connectionState->mutex);
-                        if (connectionState->currentTransaction.lock() != nullptr) {
+                        if (
+                            (connectionState->currentTransaction.lock() != nullptr)
+                            || !connectionState->pipeline.empty()
+                        ) {
                             return;
                         }
                         connectionState->broken = true;
@@ -1199,6 +1682,13 @@ namespace Http {
             };
         } else {
             impl_->persistentConnections->DropConnection(serverId, connectionState);
+            // When the pool for the server is already full, the overflow
+            // connection behaves as if persistence was never requested,
+            // so it's closed once the transaction completes rather than
+            // lingering unused.
+            if (upgradeDelegate == nullptr) {
+                persistConnection = false;
+            }
         }
         transaction->connectionState = connectionState;
         if (connectionState->connection == nullptr) {
@@ -1209,32 +1699,61 @@ namespace Http {
             return transaction;
         }
         transaction->persistConnection = persistConnection;
-        request.headers.SetHeader("Host", hostNameOrAddress);
-        request.headers.SetHeader("Accept-Encoding", "gzip, deflate");
         if (!persistConnection) {
             request.headers.SetHeader("Connection", "Close");
         }
-        if (!request.body.empty()) {
-            request.headers.SetHeader(
-                "Content-Length",
-                StringExtensions::sprintf("%zu", request.body.length())
-            );
-        }
-        const auto originalTarget = request.target;
-        request.target = Uri::Uri();
-        request.target.SetPath(originalTarget.GetPath());
-        if (originalTarget.HasQuery()) {
-            request.target.SetQuery(originalTarget.GetQuery());
-        }
-        if (originalTarget.HasFragment()) {
-            request.target.SetFragment(originalTarget.GetFragment());
-        }
         const auto requestEncoding = request.Generate();
-        connectionState->connection->SendData({requestEncoding.begin(), requestEncoding.end()});
+        connectionState->connection->SendData(
+            std::vector< uint8_t >(requestEncoding.begin(), requestEncoding.end())
+        );
+        if (
+            pipelineCandidate
+            && pooled
+        ) {
+            // This is only marked after the request has been sent, so that
+            // no other request can be pipelined behind this one and yet
+            // reach the wire ahead of it.
+            std::lock_guard< decltype(connectionState->mutex) > connectionLock(connectionState->mutex);
+            connectionState->inFlightIdempotent = true;
+        }
         impl_->AddTransaction(transaction);
         return transaction;
     }
 
+    auto Client::RequestMany(
+        std::vector< Http::Request > requests,
+        bool persistConnection
+    ) -> std::vector< std::shared_ptr< Transaction > > {
+        std::vector< std::shared_ptr< Transaction > > transactions(requests.size());
+        // The requests are grouped by origin, so that requests to the
+        // same server are posted back-to-back, making it more likely that
+        // they can share pooled connections (or be pipelined behind each
+        // other, when pipelining is enabled).
+        std::map< std::string, std::vector< size_t > > requestIndicesByOrigin;
+        for (size_t i = 0; i < requests.size(); ++i) {
+            auto port = DEFAULT_HTTP_PORT_NUMBER;
+            if (requests[i].target.HasPort()) {
+                port = requests[i].target.GetPort();
+            }
+            requestIndicesByOrigin[
+                StringExtensions::sprintf(
+                    "%s:%" PRIu16,
+                    requests[i].target.GetHost().c_str(),
+                    port
+                )
+            ].push_back(i);
+        }
+        for (const auto& origin: requestIndicesByOrigin) {
+            for (const auto index: origin.second) {
+                transactions[index] = Request(
+                    std::move(requests[index]),
+                    persistConnection
+                );
+            }
+        }
+        return transactions;
+    }
+
     void PrintTo(
         const Http::Client::Transaction::State& state,
         std::ostream* os
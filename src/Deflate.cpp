@@ -26,6 +26,147 @@ namespace {
 
 namespace Http {
 
+    /**
+     * This contains the private properties of a DeflateContext instance.
+     */
+    struct DeflateContext::Impl {
+        // Properties
+
+        /**
+         * This is the zlib stream used to compress data.
+         */
+        z_stream stream;
+
+        /**
+         * This flag indicates whether or not the zlib stream has
+         * been set up.
+         */
+        bool initialized = false;
+
+        /**
+         * This is the compression scheme for which the zlib stream
+         * was last set up.
+         */
+        DeflateMode mode = DeflateMode::Deflate;
+
+        /**
+         * This flag indicates whether or not the context is ready
+         * to compress data.
+         */
+        bool ready = false;
+    };
+
+    DeflateContext::~DeflateContext() noexcept {
+        if (impl_->initialized) {
+            deflateEnd(&impl_->stream);
+        }
+    }
+
+    DeflateContext::DeflateContext()
+        : impl_(new Impl)
+    {
+    }
+
+    bool DeflateContext::Reset(DeflateMode mode) {
+        if (impl_->initialized) {
+            if (impl_->mode == mode) {
+                impl_->ready = (deflateReset(&impl_->stream) == Z_OK);
+                return impl_->ready;
+            }
+            deflateEnd(&impl_->stream);
+            impl_->initialized = false;
+        }
+        impl_->stream.zalloc = Z_NULL;
+        impl_->stream.zfree = Z_NULL;
+        impl_->stream.opaque = Z_NULL;
+        int result;
+        if (mode == DeflateMode::Gzip) {
+            result = deflateInit2(
+                &impl_->stream,
+                Z_DEFAULT_COMPRESSION,
+                Z_DEFLATED,
+                16 + MAX_WBITS,
+                8,
+                Z_DEFAULT_STRATEGY
+            );
+        } else {
+            result = deflateInit(&impl_->stream, Z_DEFAULT_COMPRESSION);
+        }
+        impl_->initialized = (result == Z_OK);
+        impl_->mode = mode;
+        impl_->ready = impl_->initialized;
+        return impl_->ready;
+    }
+
+    bool DeflateContext::Feed(
+        const void* data,
+        size_t length,
+        std::string& output
+    ) {
+        if (!impl_->ready) {
+            return false;
+        }
+        impl_->stream.next_in = (Bytef*)data;
+        impl_->stream.avail_in = (uInt)length;
+        while (impl_->stream.avail_in != 0) {
+            const auto totalDeflatedPreviously = output.size();
+            output.resize(totalDeflatedPreviously + DEFLATE_BUFFER_INCREMENT);
+            impl_->stream.next_out = (Bytef*)&output[totalDeflatedPreviously];
+            impl_->stream.avail_out = DEFLATE_BUFFER_INCREMENT;
+            const auto result = deflate(&impl_->stream, Z_NO_FLUSH);
+            output.resize(
+                totalDeflatedPreviously
+                + DEFLATE_BUFFER_INCREMENT
+                - (size_t)impl_->stream.avail_out
+            );
+            if (
+                (result != Z_OK)
+                && (result != Z_BUF_ERROR)
+            ) {
+                impl_->ready = false;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool DeflateContext::Finish(std::string& output) {
+        if (!impl_->ready) {
+            return false;
+        }
+        impl_->stream.next_in = Z_NULL;
+        impl_->stream.avail_in = 0;
+        int result = Z_OK;
+        while (result != Z_STREAM_END) {
+            const auto totalDeflatedPreviously = output.size();
+            output.resize(totalDeflatedPreviously + DEFLATE_BUFFER_INCREMENT);
+            impl_->stream.next_out = (Bytef*)&output[totalDeflatedPreviously];
+            impl_->stream.avail_out = DEFLATE_BUFFER_INCREMENT;
+            result = deflate(&impl_->stream, Z_FINISH);
+            const auto totalDeflated = (
+                DEFLATE_BUFFER_INCREMENT
+                - (size_t)impl_->stream.avail_out
+            );
+            output.resize(totalDeflatedPreviously + totalDeflated);
+            if (
+                (result == Z_BUF_ERROR)
+                && (totalDeflated == 0)
+            ) {
+                impl_->ready = false;
+                return false;
+            } else if (
+                (result != Z_OK)
+                && (result != Z_STREAM_END)
+                && (result != Z_BUF_ERROR)
+            ) {
+                impl_->ready = false;
+                return false;
+            }
+        }
+        impl_->ready = false;
+        return true;
+    }
+
     std::vector< uint8_t > Deflate(
         const std::vector< uint8_t >& input,
         DeflateMode mode
@@ -99,11 +240,18 @@ namespace Http {
         const std::string& input,
         DeflateMode mode
     ) {
-        const auto output = Deflate(
-            std::vector< uint8_t >{input.begin(), input.end()},
-            mode
-        );
-        return std::string{output.begin(), output.end()};
+        // Each thread recycles its own compression context, so the
+        // zlib stream setup cost isn't paid again for every body.
+        thread_local DeflateContext context;
+        std::string output;
+        if (
+            !context.Reset(mode)
+            || !context.Feed(input.data(), input.length(), output)
+            || !context.Finish(output)
+        ) {
+            return {};
+        }
+        return output;
     }
 
 }
@@ -9,6 +9,8 @@
  * © 2018 by Richard Walters
  */
 
+#include <memory>
+#include <stddef.h>
 #include <stdint.h>
 #include <string>
 #include <vector>
@@ -38,6 +40,97 @@ namespace Http {
         Gzip,
     };
 
+    /**
+     * This is a reusable compression context.  It compresses data
+     * incrementally, a buffer at a time, and recycles its underlying
+     * zlib stream from one use to the next, so the cost of setting
+     * the stream up is paid only once per context rather than once
+     * per body.
+     */
+    class DeflateContext {
+        // Lifecycle management
+    public:
+        ~DeflateContext() noexcept;
+        DeflateContext(const DeflateContext&) = delete;
+        DeflateContext(DeflateContext&&) noexcept = delete;
+        DeflateContext& operator=(const DeflateContext&) = delete;
+        DeflateContext& operator=(DeflateContext&&) noexcept = delete;
+
+        // Public methods
+    public:
+        /**
+         * This is the default constructor.
+         */
+        DeflateContext();
+
+        /**
+         * This method makes the context ready to compress a new body,
+         * recycling the underlying zlib stream if one was already set
+         * up for the given compression mode.
+         *
+         * @param[in] mode
+         *     This identifies the compression scheme to use.
+         *
+         * @return
+         *     An indication of whether or not the context is ready
+         *     to compress data is returned.
+         */
+        bool Reset(DeflateMode mode);
+
+        /**
+         * This method compresses the next piece of the body, appending
+         * the compressed bytes produced so far to the given output.
+         *
+         * @param[in] data
+         *     This points to the next piece of the body to compress.
+         *
+         * @param[in] length
+         *     This is the size, in bytes, of the next piece of
+         *     the body to compress.
+         *
+         * @param[in,out] output
+         *     This is where to append the compressed bytes.
+         *
+         * @return
+         *     An indication of whether or not the data was successfully
+         *     compressed is returned.
+         */
+        bool Feed(
+            const void* data,
+            size_t length,
+            std::string& output
+        );
+
+        /**
+         * This method finishes the compressed data stream, appending
+         * the remaining compressed bytes to the given output.  Once
+         * finished, the context must be reset before it can be
+         * used again.
+         *
+         * @param[in,out] output
+         *     This is where to append the compressed bytes.
+         *
+         * @return
+         *     An indication of whether or not the compressed data
+         *     stream was successfully finished is returned.
+         */
+        bool Finish(std::string& output);
+
+        // Private properties
+    private:
+        /**
+         * This is the type of structure that contains the private
+         * properties of the instance.  It is defined in the implementation
+         * and declared here to ensure that it is scoped inside the class.
+         */
+        struct Impl;
+
+        /**
+         * This contains the private properties of the instance.
+         */
+        std::unique_ptr< Impl > impl_;
+    };
+
     /**
      * This function compresses the given vector of bytes, using
      * the given compression mode.
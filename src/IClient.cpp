@@ -0,0 +1,124 @@
+/**
+ * @file IClient.cpp
+ *
+ * This module contains the implementation of the default methods
+ * of the Http::IClient interface.
+ *
+ * © 2018 by Richard Walters
+ */
+
+#include <chrono>
+#include <condition_variable>
+#include <Http/IClient.hpp>
+#include <memory>
+#include <mutex>
+#include <stddef.h>
+#include <utility>
+#include <vector>
+
+namespace {
+
+    /**
+     * This holds the state shared between the delegates installed
+     * by Http::IClient::AwaitAnyCompletion and the caller waiting
+     * for one of the transactions to complete.
+     */
+    struct AwaitAnyState {
+        /**
+         * This is used to synchronize access to the structure.
+         */
+        std::mutex mutex;
+
+        /**
+         * This is used to wake the waiting caller once a transaction
+         * has completed.
+         */
+        std::condition_variable waitCondition;
+
+        /**
+         * This flag indicates whether or not any of the transactions
+         * has completed.
+         */
+        bool anyCompleted = false;
+
+        /**
+         * If a transaction has completed, this is the index of the first
+         * one to have done so.
+         */
+        size_t completedIndex = 0;
+    };
+
+}
+
+namespace Http {
+
+    std::vector< std::shared_ptr< IClient::Transaction > > IClient::RequestMany(
+        std::vector< Http::Request > requests,
+        bool persistConnection
+    ) {
+        std::vector< std::shared_ptr< Transaction > > transactions;
+        transactions.reserve(requests.size());
+        for (auto& request: requests) {
+            transactions.push_back(
+                Request(std::move(request), persistConnection)
+            );
+        }
+        return transactions;
+    }
+
+    bool IClient::AwaitAllCompletions(
+        const std::vector< std::shared_ptr< Transaction > >& transactions,
+        const std::chrono::milliseconds& relativeTime
+    ) {
+        const auto deadline = std::chrono::steady_clock::now() + relativeTime;
+        for (const auto& transaction: transactions) {
+            if (transaction == nullptr) {
+                continue;
+            }
+            const auto now = std::chrono::steady_clock::now();
+            const auto remainingTime = (
+                (now < deadline)
+                ? std::chrono::duration_cast< std::chrono::milliseconds >(deadline - now)
+                : std::chrono::milliseconds(0)
+            );
+            if (!transaction->AwaitCompletion(remainingTime)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    size_t IClient::AwaitAnyCompletion(
+        const std::vector< std::shared_ptr< Transaction > >& transactions,
+        const std::chrono::milliseconds& relativeTime
+    ) {
+        const auto state = std::make_shared< AwaitAnyState >();
+        for (size_t i = 0; i < transactions.size(); ++i) {
+            if (transactions[i] == nullptr) {
+                continue;
+            }
+            transactions[i]->SetCompletionDelegate(
+                [state, i]{
+                    std::lock_guard< std::mutex > lock(state->mutex);
+                    if (!state->anyCompleted) {
+                        state->anyCompleted = true;
+                        state->completedIndex = i;
+                        state->waitCondition.notify_all();
+                    }
+                }
+            );
+        }
+        std::unique_lock< std::mutex > lock(state->mutex);
+        if (
+            state->waitCondition.wait_for(
+                lock,
+                relativeTime,
+                [&state]{ return state->anyCompleted; }
+            )
+        ) {
+            return state->completedIndex;
+        }
+        return transactions.size();
+    }
+
+}
@@ -26,6 +26,155 @@ namespace {
 
 namespace Http {
 
+    /**
+     * This contains the private properties of an InflateContext instance.
+     */
+    struct InflateContext::Impl {
+        // Properties
+
+        /**
+         * This is the zlib stream used to decompress data.
+         */
+        z_stream stream;
+
+        /**
+         * This flag indicates whether or not the zlib stream has
+         * been set up.
+         */
+        bool initialized = false;
+
+        /**
+         * This is the decompression scheme for which the zlib stream
+         * was last set up.
+         */
+        InflateMode mode = InflateMode::Inflate;
+
+        /**
+         * This flag indicates whether or not the context is ready
+         * to decompress data.
+         */
+        bool ready = false;
+
+        /**
+         * This flag indicates whether or not the end of the compressed
+         * data stream has been reached.
+         */
+        bool finished = false;
+    };
+
+    InflateContext::~InflateContext() noexcept {
+        if (impl_->initialized) {
+            inflateEnd(&impl_->stream);
+        }
+    }
+
+    InflateContext::InflateContext()
+        : impl_(new Impl)
+    {
+    }
+
+    bool InflateContext::Reset(InflateMode mode) {
+        impl_->finished = false;
+        if (impl_->initialized) {
+            if (impl_->mode == mode) {
+                impl_->ready = (inflateReset(&impl_->stream) == Z_OK);
+                return impl_->ready;
+            }
+            inflateEnd(&impl_->stream);
+            impl_->initialized = false;
+        }
+        impl_->stream.zalloc = Z_NULL;
+        impl_->stream.zfree = Z_NULL;
+        impl_->stream.opaque = Z_NULL;
+        int result;
+        if (mode == InflateMode::Ungzip) {
+            result = inflateInit2(
+                &impl_->stream,
+                16 + MAX_WBITS
+            );
+        } else {
+            result = inflateInit(&impl_->stream);
+        }
+        impl_->initialized = (result == Z_OK);
+        impl_->mode = mode;
+        impl_->ready = impl_->initialized;
+        return impl_->ready;
+    }
+
+    bool InflateContext::Feed(
+        const void* data,
+        size_t length,
+        std::string& output
+    ) {
+        if (!impl_->ready) {
+            return false;
+        }
+        impl_->stream.next_in = (Bytef*)data;
+        impl_->stream.avail_in = (uInt)length;
+        while (
+            (impl_->stream.avail_in != 0)
+            && !impl_->finished
+        ) {
+            const auto totalInflatedPreviously = output.size();
+            output.resize(totalInflatedPreviously + INFLATE_BUFFER_INCREMENT);
+            impl_->stream.next_out = (Bytef*)&output[totalInflatedPreviously];
+            impl_->stream.avail_out = INFLATE_BUFFER_INCREMENT;
+            const auto result = inflate(&impl_->stream, Z_NO_FLUSH);
+            output.resize(
+                totalInflatedPreviously
+                + INFLATE_BUFFER_INCREMENT
+                - (size_t)impl_->stream.avail_out
+            );
+            if (result == Z_STREAM_END) {
+                impl_->finished = true;
+            } else if (
+                (result != Z_OK)
+                && (result != Z_BUF_ERROR)
+            ) {
+                impl_->ready = false;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool InflateContext::Finish(std::string& output) {
+        if (!impl_->ready) {
+            return false;
+        }
+        impl_->stream.next_in = Z_NULL;
+        impl_->stream.avail_in = 0;
+        while (!impl_->finished) {
+            const auto totalInflatedPreviously = output.size();
+            output.resize(totalInflatedPreviously + INFLATE_BUFFER_INCREMENT);
+            impl_->stream.next_out = (Bytef*)&output[totalInflatedPreviously];
+            impl_->stream.avail_out = INFLATE_BUFFER_INCREMENT;
+            const auto result = inflate(&impl_->stream, Z_FINISH);
+            const auto totalInflated = (
+                INFLATE_BUFFER_INCREMENT
+                - (size_t)impl_->stream.avail_out
+            );
+            output.resize(totalInflatedPreviously + totalInflated);
+            if (result == Z_STREAM_END) {
+                impl_->finished = true;
+            } else if (
+                (result == Z_BUF_ERROR)
+                && (totalInflated == 0)
+            ) {
+                impl_->ready = false;
+                return false;
+            } else if (
+                (result != Z_OK)
+                && (result != Z_BUF_ERROR)
+            ) {
+                impl_->ready = false;
+                return false;
+            }
+        }
+        impl_->ready = false;
+        return true;
+    }
+
     bool Inflate(
         const std::vector< uint8_t >& input,
         std::vector< uint8_t >& output,
@@ -95,18 +244,15 @@ namespace Http {
         std::string& output,
         InflateMode mode
     ) {
-        std::vector< uint8_t > outputBytes;
-        if (
-            !Inflate(
-                std::vector< uint8_t >{input.begin(), input.end()},
-                outputBytes,
-                mode
-            )
-        ) {
-            return false;
-        }
-        output = std::string{outputBytes.begin(), outputBytes.end()};
-        return true;
+        // Each thread recycles its own decompression context, so the
+        // zlib stream setup cost isn't paid again for every body.
+        thread_local InflateContext context;
+        output.clear();
+        return (
+            context.Reset(mode)
+            && context.Feed(input.data(), input.length(), output)
+            && context.Finish(output)
+        );
     }
 
 }
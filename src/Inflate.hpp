@@ -9,6 +9,8 @@
  * © 2018 by Richard Walters
  */
 
+#include <memory>
+#include <stddef.h>
 #include <stdint.h>
 #include <string>
 #include <vector>
@@ -38,6 +40,99 @@ namespace Http {
         Ungzip,
     };
 
+    /**
+     * This is a reusable decompression context.  It decompresses data
+     * incrementally, a buffer at a time, and recycles its underlying
+     * zlib stream from one use to the next, so the cost of setting
+     * the stream up is paid only once per context rather than once
+     * per body.
+     */
+    class InflateContext {
+        // Lifecycle management
+    public:
+        ~InflateContext() noexcept;
+        InflateContext(const InflateContext&) = delete;
+        InflateContext(InflateContext&&) noexcept = delete;
+        InflateContext& operator=(const InflateContext&) = delete;
+        InflateContext& operator=(InflateContext&&) noexcept = delete;
+
+        // Public methods
+    public:
+        /**
+         * This is the default constructor.
+         */
+        InflateContext();
+
+        /**
+         * This method makes the context ready to decompress a new body,
+         * recycling the underlying zlib stream if one was already set
+         * up for the given decompression mode.
+         *
+         * @param[in] mode
+         *     This identifies the decompression scheme to use.
+         *
+         * @return
+         *     An indication of whether or not the context is ready
+         *     to decompress data is returned.
+         */
+        bool Reset(InflateMode mode);
+
+        /**
+         * This method decompresses the next piece of the body, appending
+         * the decompressed bytes produced so far to the given output.
+         *
+         * @param[in] data
+         *     This points to the next piece of the body to decompress.
+         *
+         * @param[in] length
+         *     This is the size, in bytes, of the next piece of
+         *     the body to decompress.
+         *
+         * @param[in,out] output
+         *     This is where to append the decompressed bytes.
+         *
+         * @return
+         *     An indication of whether or not the data was successfully
+         *     decompressed is returned.
+         */
+        bool Feed(
+            const void* data,
+            size_t length,
+            std::string& output
+        );
+
+        /**
+         * This method finishes the decompression, verifying that the
+         * compressed data stream was complete and appending any
+         * remaining decompressed bytes to the given output.  Once
+         * finished, the context must be reset before it can be
+         * used again.
+         *
+         * @param[in,out] output
+         *     This is where to append the decompressed bytes.
+         *
+         * @return
+         *     An indication of whether or not the compressed data
+         *     stream was complete and successfully decompressed
+         *     is returned.
+         */
+        bool Finish(std::string& output);
+
+        // Private properties
+    private:
+        /**
+         * This is the type of structure that contains the private
+         * properties of the instance.  It is defined in the implementation
+         * and declared here to ensure that it is scoped inside the class.
+         */
+        struct Impl;
+
+        /**
+         * This contains the private properties of the instance.
+         */
+        std::unique_ptr< Impl > impl_;
+    };
+
     /**
      * This function decompresses the given vector of bytes, using
      * the given decompression mode.
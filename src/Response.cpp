@@ -7,7 +7,88 @@
  */
 
 #include <Http/Response.hpp>
-#include <sstream>
+#include <stdint.h>
+
+namespace {
+
+    /**
+     * This function appends the given number, rendered in decimal, to
+     * the given string, without going through locale-aware formatting.
+     *
+     * @param[in,out] s
+     *     This is the string to which to append the number.
+     *
+     * @param[in] value
+     *     This is the number to append to the string.
+     */
+    void AppendNumber(std::string& s, uintmax_t value) {
+        char digits[24];
+        char* digit = digits + sizeof(digits);
+        do {
+            *--digit = (char)('0' + (value % 10));
+            value /= 10;
+        } while (value != 0);
+        s.append(digit, digits + sizeof(digits) - digit);
+    }
+
+    /**
+     * This function looks up the complete status line for the given
+     * status code, if the code is one commonly issued with its
+     * standard reason phrase.
+     *
+     * @param[in] statusCode
+     *     This is the status code of the response.
+     *
+     * @param[in] reasonPhrase
+     *     This is the reason phrase of the response.
+     *
+     * @return
+     *     The complete status line, including the trailing CRLF,
+     *     is returned.
+     *
+     * @retval nullptr
+     *     This is returned if the status code isn't one of the common
+     *     ones, or the reason phrase isn't the standard one for it,
+     *     in which case the status line has to be rendered piecemeal.
+     */
+    const char* CommonStatusLine(
+        unsigned int statusCode,
+        const std::string& reasonPhrase
+    ) {
+        switch (statusCode) {
+            case 200: return (
+                (reasonPhrase == "OK")
+                ? "HTTP/1.1 200 OK\r\n" : nullptr
+            );
+            case 400: return (
+                (reasonPhrase == "Bad Request")
+                ? "HTTP/1.1 400 Bad Request\r\n" : nullptr
+            );
+            case 404: return (
+                (reasonPhrase == "Not Found")
+                ? "HTTP/1.1 404 Not Found\r\n" : nullptr
+            );
+            case 408: return (
+                (reasonPhrase == "Request Timeout")
+                ? "HTTP/1.1 408 Request Timeout\r\n" : nullptr
+            );
+            case 413: return (
+                (reasonPhrase == "Payload Too Large")
+                ? "HTTP/1.1 413 Payload Too Large\r\n" : nullptr
+            );
+            case 429: return (
+                (reasonPhrase == "Too Many Requests")
+                ? "HTTP/1.1 429 Too Many Requests\r\n" : nullptr
+            );
+            case 431: return (
+                (reasonPhrase == "Request Header Fields Too Large")
+                ? "HTTP/1.1 431 Request Header Fields Too Large\r\n" : nullptr
+            );
+            default: return nullptr;
+        }
+    }
+
+}
 
 namespace Http {
 
@@ -32,11 +113,25 @@ namespace Http {
     }
 
     std::string Response::Generate() const {
-        std::ostringstream builder;
-        builder << "HTTP/1.1 " << statusCode << ' ' << reasonPhrase << "\r\n";
-        builder << headers.GenerateRawHeaders();
-        builder << body;
-        return builder.str();
+        std::string raw;
+        GenerateTo(raw);
+        raw.append(body);
+        return raw;
+    }
+
+    void Response::GenerateTo(std::string& head) const {
+        head.clear();
+        const auto statusLine = CommonStatusLine(statusCode, reasonPhrase);
+        if (statusLine == nullptr) {
+            head.append("HTTP/1.1 ");
+            AppendNumber(head, statusCode);
+            head.append(1, ' ');
+            head.append(reasonPhrase);
+            head.append("\r\n");
+        } else {
+            head.append(statusLine);
+        }
+        head.append(headers.GenerateRawHeaders());
     }
 
 }
@@ -9,12 +9,17 @@
 #include "Deflate.hpp"
 
 #include <algorithm>
+#include <atomic>
 #include <condition_variable>
-#include <deque>
+#include <functional>
 #include <Http/Server.hpp>
 #include <inttypes.h>
 #include <iomanip>
+#include <iterator>
+#include <limits>
+#include <list>
 #include <map>
+#include <math.h>
 #include <memory>
 #include <mutex>
 #include <queue>
@@ -23,8 +28,12 @@
 #include <stddef.h>
 #include <stdio.h>
 #include <string>
+#include <string.h>
 #include <StringExtensions/StringExtensions.hpp>
 #include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace {
 
@@ -125,6 +134,72 @@ namespace {
      */
     constexpr double DEFAULT_TOO_MANY_CONNECTS_MEASUREMENT_PERIOD = 1.0;
 
+    /**
+     * This is the default number of independent shards across which
+     * the server partitions its connections, so that requests arriving
+     * on different connections can be parsed in parallel.
+     */
+    constexpr size_t DEFAULT_CONNECTION_SHARDS = 4;
+
+    /**
+     * This is the maximum number of spare request objects to keep on
+     * each connection for reuse.
+     */
+    constexpr size_t MAX_SPARE_REQUESTS_PER_CONNECTION = 2;
+
+    /**
+     * This is the default maximum number of client dossiers for the
+     * server to keep.  When the limit is reached, the dossiers of the
+     * least recently seen unbanned clients are dropped.
+     */
+    constexpr size_t DEFAULT_MAX_CLIENT_DOSSIERS = 10000;
+
+    /**
+     * This is the default maximum total number of bytes of serialized
+     * responses for the server to keep in its response cache, on
+     * behalf of handlers which mark their responses cacheable.
+     */
+    constexpr size_t DEFAULT_RESPONSE_CACHE_SIZE = 1000000;
+
+    /**
+     * This is the default size of a connection's send queue, in bytes,
+     * at or below which a streamed resource handler which paused sending
+     * is told that it may resume.
+     */
+    constexpr size_t DEFAULT_SEND_QUEUE_LOW_WATERMARK = 65536;
+
+    /**
+     * This is the maximum number of diagnostic messages that may be
+     * waiting to be published by the reaper thread at any one time,
+     * when asynchronous diagnostics are enabled.  Messages beyond this
+     * limit are counted and dropped.
+     */
+    constexpr size_t MAX_QUEUED_DIAGNOSTIC_MESSAGES = 1024;
+
+    /**
+     * This is the value the cached minimum subscribed diagnostic level
+     * takes when there are no diagnostic message subscribers at all,
+     * so that no message passes the level gate.
+     */
+    constexpr size_t NO_DIAGNOSTIC_SUBSCRIBERS = std::numeric_limits< size_t >::max();
+
+    /**
+     * This is the width, in seconds, of each slot of the wheel used
+     * to keep track of connection timeouts.  The timeouts themselves
+     * are second-granularity, so firing one up to this much late
+     * is harmless.
+     */
+    constexpr double TIMEOUT_WHEEL_SLOT_WIDTH = 0.1;
+
+    /**
+     * This is the number of slots in the wheel used to keep track of
+     * connection timeouts.  Together with the slot width, this sets
+     * the farthest ahead a timeout can be binned directly; a timeout
+     * due even farther out is re-binned each time the wheel comes
+     * back around to its slot.
+     */
+    constexpr size_t TIMEOUT_WHEEL_NUM_SLOTS = 1024;
+
     /**
      * This is used to indicate how to handle the server's end
      * of a connection.
@@ -187,6 +262,21 @@ namespace {
          */
         Http::Server::ResourceDelegate handler;
 
+        /**
+         * This is the delegate to call to stream a response for any
+         * resource requests within this space.  If nullptr, the space
+         * either has a non-streamed handler or is divided into subspaces.
+         */
+        Http::Server::StreamedResourceDelegate streamedHandler;
+
+        /**
+         * This is the delegate to call as soon as the headers arrive for
+         * any resource requests within this space, delivering the body
+         * incrementally.  If nullptr, the space either has another kind
+         * of handler or is divided into subspaces.
+         */
+        Http::Server::StreamedRequestResourceDelegate streamedRequestHandler;
+
         /**
          * If the space is divided into subspaces, these are the
          * subspaces which have currently registered handler delegates.
@@ -200,6 +290,27 @@ namespace {
         std::weak_ptr< ResourceSpace > superspace;
     };
 
+    /**
+     * This is one node of the compiled form of the resource space tree,
+     * used to route request paths to handlers.  The nodes of the tree
+     * are laid out in a single flat vector, and the subspaces of each
+     * node are kept sorted by name, so that a path can be matched in
+     * one pass with a binary search per segment and no allocations.
+     */
+    struct CompiledRouterNode {
+        /**
+         * These are the names and node indices of the subspaces of
+         * this node, sorted by name.
+         */
+        std::vector< std::pair< std::string, size_t > > subspaces;
+
+        /**
+         * This is the resource space from which this node was compiled,
+         * holding any handler delegates registered for it.
+         */
+        std::shared_ptr< ResourceSpace > space;
+    };
+
     /**
      * This is a helper function which formats the given double-precision
      * floating-point value as a string, ensuring that it will always
@@ -220,16 +331,84 @@ namespace {
         return s;
     }
 
+    /**
+     * This function renders the given number in decimal as a string,
+     * without going through printf-style formatting.  The result is
+     * short enough to fit in a string's internal small-string storage,
+     * so no heap allocation is involved.
+     *
+     * @param[in] value
+     *     This is the number to render.
+     *
+     * @return
+     *     A string representation of the number is returned.
+     */
+    std::string NumberToString(size_t value) {
+        char digits[24];
+        char* digit = digits + sizeof(digits);
+        do {
+            *--digit = (char)('0' + (value % 10));
+            value /= 10;
+        } while (value != 0);
+        return std::string(digit, digits + sizeof(digits) - digit);
+    }
+
+    /**
+     * This function finds the offset of the first carriage-return/line-feed
+     * sequence in the given span of characters.
+     *
+     * @param[in] data
+     *     This points to the first character of the span to scan.
+     *
+     * @param[in] length
+     *     This is the number of characters in the span to scan.
+     *
+     * @return
+     *     The offset of the first CRLF sequence in the span is returned.
+     *
+     * @retval std::string::npos
+     *     This is returned if the span contains no CRLF sequence.
+     */
+    size_t FindCRLF(
+        const char* data,
+        size_t length
+    ) {
+        // The C library vectorizes memchr to scan many characters per
+        // instruction, so hunt for carriage returns with it and check
+        // each one for a following line feed, rather than stepping
+        // through the span one character at a time.
+        auto candidate = data;
+        auto remaining = length;
+        while (remaining > 1) {
+            const auto cr = (const char*)memchr(candidate, '\r', remaining - 1);
+            if (cr == nullptr) {
+                return std::string::npos;
+            }
+            if (cr[1] == '\n') {
+                return (size_t)(cr - data);
+            }
+            candidate = cr + 1;
+            remaining = length - (size_t)(candidate - data);
+        }
+        return std::string::npos;
+    }
+
     /**
      * This method parses the method, target URI, and protocol identifier
-     * from the given request line.
+     * from the given request line.  The request line is given as a span
+     * of the caller's buffer, so that no intermediate copy of it
+     * needs to be made.
      *
      * @param[in] request
      *     This is the request in which to store the parsed method and
      *     target URI.
      *
      * @param[in] requestLine
-     *     This is the raw request line string to parse.
+     *     This points to the first character of the raw request line.
+     *
+     * @param[in] requestLineLength
+     *     This is the number of characters in the raw request line,
+     *     not including the line terminator.
      *
      * @return
      *     An indication of whether or not the request line
@@ -237,855 +416,2843 @@ namespace {
      */
     bool ParseRequestLine(
         Http::Request& request,
-        const std::string& requestLine
+        const char* requestLine,
+        size_t requestLineLength
     ) {
         // Parse the method.
-        const auto methodDelimiter = requestLine.find(' ');
-        if (methodDelimiter == std::string::npos) {
+        const auto requestLineEnd = requestLine + requestLineLength;
+        const auto methodDelimiter = std::find(requestLine, requestLineEnd, ' ');
+        if (methodDelimiter == requestLineEnd) {
             return false;
         }
-        request.method = requestLine.substr(0, methodDelimiter);
+        request.method.assign(requestLine, methodDelimiter);
         if (request.method.empty()) {
             return false;
         }
 
-        // Parse the target URI.
-        const auto targetDelimiter = requestLine.find(' ', methodDelimiter + 1);
-        if (targetDelimiter == std::string::npos) {
-            return false;
-        }
-        const auto targetLength = targetDelimiter - methodDelimiter - 1;
-        if (targetLength == 0) {
-            return false;
-        }
+        // Parse the target URI.  The raw bytes of the target are kept
+        // with the request, so that they can be shown in diagnostic
+        // messages exactly as the client sent them, without having to
+        // re-render the parsed URI.
+        const auto targetStart = methodDelimiter + 1;
+        const auto targetDelimiter = std::find(targetStart, requestLineEnd, ' ');
         if (
-            !request.target.ParseFromString(
-                requestLine.substr(
-                    methodDelimiter + 1,
-                    targetLength
-                )
-            )
+            (targetDelimiter == requestLineEnd)
+            || (targetDelimiter == targetStart)
         ) {
             return false;
         }
+        request.rawTarget.assign(targetStart, targetDelimiter);
+        if (!request.target.ParseFromString(request.rawTarget)) {
+            return false;
+        }
 
         // Parse the protocol.
-        const auto protocol = requestLine.substr(targetDelimiter + 1);
-        return (protocol == "HTTP/1.1");
+        const auto protocolLength = (size_t)(requestLineEnd - targetDelimiter - 1);
+        return (
+            (protocolLength == 8)
+            && (memcmp(targetDelimiter + 1, "HTTP/1.1", 8) == 0)
+        );
     }
 
     /**
-     * This structure holds onto all state information the server has
-     * about a single connection from a client.
+     * This is a byte buffer used to reassemble fragmented HTTP requests.
+     * Received data is appended at the end, and consumed characters are
+     * released from the front by advancing a cursor, so that releasing
+     * them costs amortized constant time instead of shifting the
+     * entire remaining contents after every parsed request.
      */
-    struct ConnectionState {
-        // Properties
+    class InputBuffer {
+        // Public methods
+    public:
+        /**
+         * This method appends the given data to the end of the buffer.
+         *
+         * @param[in] data
+         *     This is the data to append to the end of the buffer.
+         */
+        void Append(const std::vector< uint8_t >& data) {
+            buffer.append(
+                (const char*)data.data(),
+                data.size()
+            );
+        }
 
         /**
-         * This is the transport interface of the connection.
+         * This method releases the given number of characters from
+         * the front of the buffer.
+         *
+         * The characters are released by advancing the consumed-characters
+         * cursor; the underlying storage is only compacted once the
+         * consumed characters outnumber the remaining ones, making the
+         * cost of releasing characters amortized constant.
+         *
+         * @param[in] length
+         *     This is the number of characters to release from
+         *     the front of the buffer.
          */
-        std::shared_ptr< Http::Connection > connection;
+        void Consume(size_t length) {
+            offset += length;
+            if (offset >= buffer.length()) {
+                buffer.clear();
+                offset = 0;
+            } else if (offset > buffer.length() - offset) {
+                (void)buffer.erase(0, offset);
+                offset = 0;
+            }
+        }
 
         /**
-         * This is the time reported by the time keeper when
-         * data was last received from the client.
+         * This method returns a pointer to the first character
+         * not yet consumed from the buffer.
+         *
+         * @return
+         *     A pointer to the first character not yet consumed
+         *     from the buffer is returned.
          */
-        double timeLastDataReceived = 0.0;
+        const char* Data() const {
+            return buffer.data() + offset;
+        }
 
         /**
-         * When a request is in progress, this is the token obtained
-         * from the scheduler for the scheduled inactivity timeout callback.
+         * This method returns the number of characters not yet
+         * consumed from the buffer.
+         *
+         * @return
+         *     The number of characters not yet consumed from
+         *     the buffer is returned.
          */
-        int inactivityTimeoutToken = 0;
+        size_t Length() const {
+            return buffer.length() - offset;
+        }
 
         /**
-         * This is the time reported by the time keeper when
-         * the current request was started.
+         * This method returns an indication of whether or not all
+         * characters in the buffer have been consumed.
+         *
+         * @return
+         *     An indication of whether or not all characters in
+         *     the buffer have been consumed is returned.
          */
-        double timeLastRequestStarted = 0.0;
+        bool IsEmpty() const {
+            return (offset == buffer.length());
+        }
 
         /**
-         * When a request is in progress, this is the token obtained
-         * from the scheduler for the scheduled request timeout callback.
+         * This method returns a copy of the characters not yet
+         * consumed from the buffer, as a string.
+         *
+         * @return
+         *     A copy of the characters not yet consumed from the buffer
+         *     is returned as a string.
          */
-        int requestTimeoutToken = 0;
+        std::string ToString() const {
+            return buffer.substr(offset);
+        }
 
+        // Private properties
+    private:
         /**
-         * This is the time reported by the time keeper when
-         * a graceful close was initiated on the connection.
+         * This holds the characters in the buffer, including any
+         * already consumed.
          */
-        double timeClosedGracefully = 0.0;
+        std::string buffer;
 
         /**
-         * This flag indicates whether or not the client is currently
-         * issuing a request to the server.
+         * This is the number of characters at the front of the buffer
+         * which have already been consumed.
          */
-        bool requestInProgress = false;
+        size_t offset = 0;
+    };
 
+    /**
+     * This holds the running totals one connection shard keeps about
+     * the traffic it has handled.  The structure is aligned to its own
+     * cache line, so that counts updated on different shards don't
+     * contend for the same line.  All counts are updated with relaxed
+     * atomic operations, trading a little precision in snapshots for
+     * minimal overhead on the hot path.
+     */
+    struct alignas(64) ShardMetrics {
         /**
-         * When no request is in progress, this is the token obtained
-         * from the scheduler for the scheduled idle timeout callback.
+         * This is the number of requests received and parsed.
          */
-        int idleTimeoutToken = 0;
+        std::atomic< size_t > requestsReceived{0};
 
         /**
-         * This buffer is used to reassemble fragmented HTTP requests
-         * received from the client.
+         * This is the number of responses issued with 1xx status codes.
          */
-        std::string reassemblyBuffer;
+        std::atomic< size_t > responsesInformational{0};
 
         /**
-         * This holds the beginning of the current request, used to
-         * report the bytes received for a bad request.
+         * This is the number of responses issued with 2xx status codes.
          */
-        std::vector< uint8_t > requestExtract;
+        std::atomic< size_t > responsesSuccess{0};
 
         /**
-         * This is the state of the next request, while it's still
-         * being received and parsed.
+         * This is the number of responses issued with 3xx status codes.
          */
-        std::shared_ptr< Http::Request > nextRequest = std::make_shared< Http::Request >();
+        std::atomic< size_t > responsesRedirection{0};
 
         /**
-         * This flag indicates whether or not the server is still
-         * accepting requests from the client.
+         * This is the number of responses issued with 4xx status codes.
          */
-        bool acceptingRequests = true;
+        std::atomic< size_t > responsesClientError{0};
 
         /**
-         * This flag indicates whether or not the server has closed
-         * its end of the connection.
+         * This is the number of responses issued with 5xx status codes.
          */
-        bool serverClosed = false;
+        std::atomic< size_t > responsesServerError{0};
 
         /**
-         * This flag indicates whether or not the client has closed
-         * its end of the connection.
+         * This is the number of requests denied because their clients
+         * exceeded the request rate limit.
          */
-        bool clientClosed = false;
-    };
+        std::atomic< size_t > requestsRejectedTooMany{0};
 
-    /**
-     * This holds information about a client of the web server.
-     */
-    struct ClientDossier {
         /**
-         * This is the number of seconds that the client will be
-         * ignored, counting from the moment the ban was imposed.
+         * This is the number of requests served straight from the
+         * response cache, without invoking any handler.
          */
-        double banPeriod = DEFAULT_BAN_PERIOD_SECONDS;
+        std::atomic< size_t > responseCacheHits{0};
 
         /**
-         * This is a sampling of the time, according to the server's
-         * timekeeper, when this client was last banned.
+         * This is the number of requests which consulted the response
+         * cache but had to invoke their handlers anyway.
          */
-        double banStart = 0.0;
+        std::atomic< size_t > responseCacheMisses{0};
 
         /**
-         * This flag indicates whether or not the client
-         * is currently banned or on probation.
+         * This is the number of bytes received from clients.
          */
-        bool banned = false;
+        std::atomic< size_t > bytesReceived{0};
+
+        /**
+         * This is the number of bytes sent to clients.
+         */
+        std::atomic< size_t > bytesSent{0};
+
+        /**
+         * This is the amount of time spent parsing requests,
+         * in microseconds.
+         */
+        std::atomic< size_t > parseTimeMicroseconds{0};
+
+        /**
+         * This is the amount of time spent inside resource handlers,
+         * in microseconds.
+         */
+        std::atomic< size_t > handlerTimeMicroseconds{0};
 
         /**
-         * These are samples of the time keeper at each point
-         * when the client made a request in the past.
+         * This method counts the given response against the counter
+         * matching its status code class.
+         *
+         * @param[in] statusCode
+         *     This is the status code of the response to count.
          */
-        std::deque< double > lastRequestTimes;
+        void CountResponse(unsigned int statusCode) {
+            switch (statusCode / 100) {
+                case 1: {
+                    responsesInformational.fetch_add(1, std::memory_order_relaxed);
+                } break;
+                case 2: {
+                    responsesSuccess.fetch_add(1, std::memory_order_relaxed);
+                } break;
+                case 3: {
+                    responsesRedirection.fetch_add(1, std::memory_order_relaxed);
+                } break;
+                case 4: {
+                    responsesClientError.fetch_add(1, std::memory_order_relaxed);
+                } break;
+                case 5: {
+                    responsesServerError.fetch_add(1, std::memory_order_relaxed);
+                } break;
+                default: {
+                } break;
+            }
+        }
     };
 
     /**
-     * This holds the arguments to pass when calling any registered
-     * ban delegates.
+     * This holds the subset of server state which belongs to a single
+     * connection shard.  Each connection is assigned to exactly one shard,
+     * and all per-connection receiving and parsing state is guarded by
+     * the shard's own mutex, so that connections assigned to different
+     * shards can be serviced in parallel.
      */
-    struct BanDelegateArguments {
+    struct ConnectionShard {
         /**
-         * This is the address of the peer whose connections should be banned.
+         * This is used to synchronize access to the connections
+         * assigned to this shard.
          */
-        std::string peerAddress;
+        std::recursive_mutex mutex;
 
         /**
-         * This is an explanation of the ban to report through the diagnostics
-         * system.
+         * These are the currently active client connections
+         * assigned to this shard.
          */
-        std::string reason;
-    };
+        std::set< std::shared_ptr< struct ConnectionState > > activeConnections;
 
-}
+        /**
+         * These are the running totals the shard keeps about the
+         * traffic it has handled.
+         */
+        ShardMetrics metrics;
+    };
 
-namespace Http {
+    /**
+     * This structure holds everything the server knows and tracks
+     * about a single client, addressed by the client's address.
+     * It's defined later in this file.
+     */
+    struct ClientDossier;
 
     /**
-     * This contains the private properties of a Server instance.
+     * This structure holds onto all state information the server has
+     * about a single connection from a client.
      */
-    struct Server::Impl {
+    struct ConnectionState {
         // Properties
 
         /**
-         * This refers back to the server whose private properties
-         * are stored here.
+         * This is the transport interface of the connection.
          */
-        Server* server = nullptr;
+        std::shared_ptr< Http::Connection > connection;
 
         /**
-         * This holds all configuration items for the server.
+         * This is the shard to which the connection is assigned,
+         * whose mutex guards the state held here.
          */
-        std::map< std::string, std::string > configuration;
+        std::shared_ptr< ConnectionShard > shard;
 
         /**
-         * This is the maximum allowed total message size.
+         * This is the address of the client at the other end of the
+         * connection, cached when the connection is established so that
+         * per-request bookkeeping doesn't have to fetch it from the
+         * transport again.
          */
-        size_t maxMessageSize = DEFAULT_MAX_MESSAGE_SIZE;
+        std::string clientAddress;
 
         /**
-         * This is the maximum number of characters allowed on any header line
-         * of an HTTP request.
+         * This points to the dossier the server holds about the client,
+         * cached so that per-request bookkeeping doesn't have to look
+         * it up by address.  It's only valid while dossierGeneration
+         * matches the server's dossier eviction generation.
          */
-        size_t headerLineLimit = DEFAULT_HEADER_LINE_LIMIT;
+        ClientDossier* dossier = nullptr;
 
         /**
-         * This is the number of bytes of every bad request to
-         * be reported in diagnostic messages.
+         * This is the server's dossier eviction generation at the time
+         * the dossier pointer was cached.
          */
-        size_t badRequestReportBytes = DEFAULT_BAD_REQUEST_REPORT_BYTES;
+        size_t dossierGeneration = 0;
 
         /**
-         * This is the public port number to which clients may connect
-         * to establish connections with this server.
+         * This flag indicates whether or not the client was on the
+         * server's acceptlist when it was last checked.  It's only
+         * valid while acceptlistGeneration matches the server's
+         * acceptlist generation.
          */
-        uint16_t port = DEFAULT_PORT_NUMBER;
+        bool acceptlisted = false;
 
         /**
-         * This is the default maximum number of seconds to allow to elapse
-         * between the end of a request, or the beginning of a connection,
-         * and receiving the first byte of a new client request,
-         * before timing out.
+         * This is the server's acceptlist generation at the time the
+         * acceptlisted flag was cached.
          */
-        double idleTimeout = DEFAULT_IDLE_TIMEOUT_SECONDS;
+        size_t acceptlistGeneration = 0;
 
         /**
-         * This is the maximum number of seconds to allow to elapse
-         * between receiving one byte of a client request and
-         * receiving the next byte, before timing out.
+         * This is the time reported by the time keeper when
+         * data was last received from the client.
          */
-        double inactivityTimeout = DEFAULT_INACTIVITY_TIMEOUT_SECONDS;
+        double timeLastDataReceived = 0.0;
 
         /**
-         * This is the maximum number of seconds to allow to elapse
-         * between initiating a graceful close on connection and
-         * forcing the connection closed ungracefully.
+         * When a request is in progress, this is the time, as reported
+         * by the time keeper, after which the server should time out
+         * the request due to inactivity.  This is 0.0 when no
+         * inactivity timeout is armed.
          */
-        double gracefulCloseTimeout = DEFAULT_GRACEFUL_CLOSE_TIMEOUT_SECONDS;
+        double inactivityTimeoutDue = 0.0;
 
         /**
-         * This is the maximum number of seconds to allow to elapse
-         * between receiving the first byte of a client request and
-         * receiving the last byte of the request, before timing out.
+         * This is the time reported by the time keeper when
+         * the current request was started.
          */
-        double requestTimeout = DEFAULT_REQUEST_TIMEOUT_SECONDS;
+        double timeLastRequestStarted = 0.0;
 
         /**
-         * This is the amount of time a client should be initially banned
-         * in response to a bad request or too many requests.
+         * When a request is in progress, this is the time, as reported
+         * by the time keeper, after which the server should time out
+         * the request for taking too long overall.  This is 0.0 when
+         * no request timeout is armed.
          */
-        double initialBanPeriod = DEFAULT_BAN_PERIOD_SECONDS;
+        double requestTimeoutDue = 0.0;
 
         /**
-         * This is the amount of time required after a client's ban
-         * has been lifted, before the client's ban period will be reset.
+         * This is the time reported by the time keeper when
+         * a graceful close was initiated on the connection.
          */
-        double probationPeriod = DEFAULT_PROBATION_PERIOD_SECONDS;
+        double timeClosedGracefully = 0.0;
 
         /**
-         * This is the threshold, in requests per second, after which
-         * a client will be banned.
+         * This flag indicates whether or not the client is currently
+         * issuing a request to the server.
          */
-        double tooManyRequestsThreshold = DEFAULT_TOO_MANY_REQUESTS_THRESHOLD;
+        bool requestInProgress = false;
 
         /**
-         * This is the period of time over which the number of requests
-         * made by a client is measured.
+         * When no request is in progress, this is the time, as reported
+         * by the time keeper, after which the server should close the
+         * connection for being idle.  This is 0.0 when no idle timeout
+         * is armed.
          */
-        double tooManyRequestsMeasurementPeriod = DEFAULT_TOO_MANY_REQUESTS_MEASUREMENT_PERIOD;
+        double idleTimeoutDue = 0.0;
 
         /**
-         * This is the threshold, in connect requests per second, after which
-         * new requests will be denied.
+         * This flag indicates whether or not the connection currently
+         * has a live entry in the server's timeout wheel.
          */
-        double tooManyConnectsThreshold = DEFAULT_TOO_MANY_CONNECTS_THRESHOLD;
+        bool inTimeoutWheel = false;
 
         /**
-         * This is the period of time over which the number of connect requests
-         * by clients is measured.
+         * While the connection has a live entry in the server's timeout
+         * wheel, this is the tick of the slot holding the entry.
          */
-        double tooManyConnectsMeasurementPeriod = DEFAULT_TOO_MANY_CONNECTS_MEASUREMENT_PERIOD;
+        size_t timeoutWheelBinTick = 0;
 
         /**
-         * This flag indicates whether or not the server is running.
+         * This buffer is used to reassemble fragmented HTTP requests
+         * received from the client.
          */
-        bool mobilized = false;
+        InputBuffer reassemblyBuffer;
 
         /**
-         * This is the transport layer currently bound.
+         * This holds the beginning of the current request, used to
+         * report the bytes received for a bad request.
          */
-        std::shared_ptr< ServerTransport > transport;
+        std::vector< uint8_t > requestExtract;
 
         /**
-         * This is the object used to track time in the server.
+         * This is the state of the next request, while it's still
+         * being received and parsed.
          */
-        std::shared_ptr< TimeKeeper > timeKeeper;
+        std::shared_ptr< Http::Request > nextRequest = std::make_shared< Http::Request >();
 
         /**
-         * This is used to schedule work to be done without having to
-         * poll the timekeeper.
+         * These are request objects which have finished their turns
+         * through the request pipeline and are kept to be reused for
+         * subsequent requests on the connection, rather than allocating
+         * a fresh object for every request.
          */
-        std::unique_ptr< Timekeeping::Scheduler > scheduler;
+        std::vector< std::shared_ptr< Http::Request > > spareRequests;
 
         /**
-         * This holds information about known clients of the server.
+         * This buffer is reused across requests on the connection to
+         * hold the serialized head of each response while it's
+         * being sent.
          */
-        std::map< std::string, ClientDossier > clients;
+        std::string responseHeadBuffer;
 
         /**
-         * This holds the addresses of clients that have been "acceptlisted",
-         * or are immune to bans and not checked against rate limits.
+         * This flag indicates whether or not the server is still
+         * accepting requests from the client.
          */
-        std::set< std::string > acceptlist;
+        bool acceptingRequests = true;
 
         /**
-         * These are the currently active client connections.
+         * This flag indicates whether or not the server has closed
+         * its end of the connection.
          */
-        std::set< std::shared_ptr< ConnectionState > > activeConnections;
+        bool serverClosed = false;
 
         /**
-         * These are the client connections that are no longer
-         * managed by the server (because they have either broken or
-         * have been upgraded and are now handled by a resource) and will
-         * be dropped by the reaper thread.
+         * This flag indicates whether or not the client has closed
+         * its end of the connection.
          */
-        std::set< std::shared_ptr< ConnectionState > > connectionsToDrop;
+        bool clientClosed = false;
 
         /**
-         * This holds the arguments for any ban delegate calls that have
-         * been queued to be called by the reaper thread.
+         * This flag indicates whether or not a streamed response is
+         * currently being sent on the connection.  While it's set,
+         * the server holds off parsing any subsequent requests
+         * received on the connection.
          */
-        std::queue< BanDelegateArguments > queuedBanDelegateCallArguments;
+        bool streamedResponseInProgress = false;
 
         /**
-         * This holds all registered ban delegates.
+         * While a streamed response is being sent on the connection,
+         * this is the function to call if the connection is broken,
+         * so that the handler streaming the response can be told
+         * to stop.
          */
-        std::map< int, BanDelegate > banDelegates;
+        std::function< void() > abandonStreamedResponse;
 
         /**
-         * This is the next unique identification number to assign to
-         * a registered ban delegate.
+         * While the body of a request claimed by a streamed request
+         * handler is still arriving on the connection, this is the
+         * reader through which the body is delivered to the handler.
          */
-        int nextBanDelegateId = 1;
+        std::shared_ptr< struct ServerRequestReader > requestReader;
+    };
 
+    /**
+     * This is a timing wheel used to keep track of connection timeouts.
+     * Each connection with at least one timeout armed has an entry in
+     * the slot covering the time its earliest timeout comes due, so
+     * arming, disarming, and rescheduling a timeout are all constant
+     * time, no matter how many connections the server is juggling.
+     * The wheel is advanced one slot at a time by a single callback
+     * scheduled with the server's scheduler.
+     */
+    struct TimeoutWheel {
         /**
-         * This is a helper object used to generate and publish
-         * diagnostic messages.
+         * This is used to synchronize access to the wheel.  It is a
+         * leaf lock: no other lock is ever acquired while holding it.
          */
-        SystemAbstractions::DiagnosticsSender diagnosticsSender;
+        std::mutex mutex;
 
         /**
-         * These are samples of the time keeper at each point
-         * when a connection request was made a request in the past.
+         * These are the slots of the wheel.  Each slot holds the
+         * connections whose earliest timeout comes due during the
+         * slot's turn of the wheel.
          */
-        std::deque< double > lastConnectTimes;
+        std::vector< std::vector< std::weak_ptr< ConnectionState > > > slots{TIMEOUT_WHEEL_NUM_SLOTS};
 
         /**
-         * This flag indicates whether or not the last connection request
-         * was denied due to exceeding the connection request rate limit.
+         * This is the tick of the last slot whose turn has passed.
+         * Tick N covers times up to (N * TIMEOUT_WHEEL_SLOT_WIDTH)
+         * seconds, and is held by slot (N % TIMEOUT_WHEEL_NUM_SLOTS).
          */
-        bool connectRateLimited = false;
+        size_t currentTick = 0;
+    };
+
+    /**
+     * This is the implementation of the response writer interface which
+     * the server hands to streamed resource handlers.  It frames each
+     * piece of the response body using the chunked transfer coding,
+     * unless the handler supplied a "Content-Length" header.
+     */
+    struct ServerResponseWriter
+        : public Http::IServer::ResponseWriter
+    {
+        // Properties
 
         /**
-         * This is a worker thread which clears the connectionsToDrop set
-         * and completes any queued delegate calls.  This prevents deadlocks
-         * since these activities must be done without holding the server's
-         * mutex.
+         * This is the state of the connection on which to send
+         * the response.
          */
-        std::thread reaper;
+        std::weak_ptr< ConnectionState > connectionStateWeak;
 
         /**
-         * This flag indicates whether or not the reaper thread should stop.
+         * This is the function to call once the response is finished,
+         * so that the server can resume processing requests received
+         * on the connection.
+         *
+         * @param[in] closeRequested
+         *     This indicates whether or not the connection should be
+         *     closed once the response is finished.
          */
-        bool stopReaper = false;
+        std::function< void(bool closeRequested) > finishedDelegate;
 
         /**
-         * This represents the entire space of resources under this server.
+         * This is the function to call if the connection is broken
+         * before the response is finished.
          */
-        std::shared_ptr< ResourceSpace > resources;
+        AbandonedDelegate abandonedDelegate;
 
         /**
-         * This is used to synchronize access to the server.
+         * This flag indicates whether or not the status line and headers
+         * of the response have been sent.
          */
-        std::recursive_mutex mutex;
+        bool headersSent = false;
 
         /**
-         * This is used by the reaper thread to wait on any
-         * condition that it should cause it to wake up.
+         * This flag indicates whether or not the response has either
+         * been finished or abandoned.
          */
-        std::condition_variable_any reaperWakeCondition;
+        bool finished = false;
 
-        // Methods
+        /**
+         * This flag indicates whether or not the body of the response
+         * is being framed using the chunked transfer coding.
+         */
+        bool chunked = false;
 
         /**
-         * This is the constructor for the structure.
+         * This flag indicates whether or not the connection should be
+         * closed once the response is finished.
          */
-        Impl()
-            : diagnosticsSender("Http::Server")
-        {
-        }
+        bool closeAfterResponse = false;
 
         /**
-         * This is the template of a helper function which is used to
-         * parse a configuration item and set it if the parsing is successful.
-         *
-         * @param ItemType
-         *     This is the type of the configuration item.
-         *
-         * @param[in,out] item
-         *     This is the configuration item to set.
-         *
-         * @param[in] scanFormat
-         *     This is the scanf-style format specification for printing
-         *     the configuration item.
-         *
-         * @param[in] printFormat
-         *     This is the printf-style format specification for printing
-         *     the configuration item.
-         *
-         * @param[in] description
-         *     This is the string to display in diagnostic messages about
-         *     the configuration item.
-         *
-         * @param[in] value
-         *     This is the value to parse to be the new value of the item.
+         * This is the size of the connection's send queue, in bytes,
+         * at or below which the handler's writable delegate should
+         * be called.
          */
-        template<
-            typename ItemType
-        > void ParseConfigurationItem(
-            ItemType& item,
-            const char* const scanFormat,
-            const char* const printFormat,
-            const char* const description,
-            const std::string& value
-        ) {
-            ItemType newItem;
+        size_t sendQueueLowWatermark = 0;
+
+        // Methods
+
+        /**
+         * This method is called by the server if the connection is broken
+         * before the response is finished, in order to notify the handler
+         * streaming the response that it should stop.
+         */
+        void NotifyAbandoned() {
+            if (finished) {
+                return;
+            }
+            finished = true;
+            if (abandonedDelegate != nullptr) {
+                abandonedDelegate();
+            }
+        }
+
+        // Http::IServer::ResponseWriter
+
+        virtual void SendResponseHeaders(Http::Response& response) override {
+            const auto connectionState = connectionStateWeak.lock();
+            if (connectionState == nullptr) {
+                return;
+            }
+            std::lock_guard< decltype(connectionState->shard->mutex) > lock(connectionState->shard->mutex);
             if (
-                sscanf(
-                    value.c_str(),
-                    scanFormat,
-                    &newItem
-                ) == 1
+                headersSent
+                || finished
+                || connectionState->serverClosed
             ) {
-                if (item != newItem) {
-                    diagnosticsSender.SendDiagnosticInformationFormatted(
-                        0,
-                        StringExtensions::sprintf(
-                            "%s changed from %s to %s",
-                            description,
-                            printFormat,
-                            printFormat
-                        ).c_str(),
-                        item,
-                        newItem
-                    );
-                    item = newItem;
-                }
+                return;
+            }
+            if (
+                !response.headers.HasHeader("Content-Length")
+                && !response.headers.HasHeaderToken("Transfer-Encoding", "chunked")
+            ) {
+                response.headers.SetHeader("Transfer-Encoding", "chunked");
             }
+            chunked = response.headers.HasHeaderToken("Transfer-Encoding", "chunked");
+            if (response.headers.HasHeaderToken("Connection", "close")) {
+                closeAfterResponse = true;
+            }
+            std::string head;
+            response.GenerateTo(head);
+            connectionState->connection->SendData(
+                std::vector< uint8_t >(head.begin(), head.end())
+            );
+            headersSent = true;
         }
 
-        /**
-         * This method is the body of the reaper thread.
-         * Until it's told to stop, it simply clears
-         * the connectionsToDrop set whenever it wakes up.
-         */
-        void Reaper() {
-            std::unique_lock< decltype(mutex) > lock(mutex);
-            while (!stopReaper) {
-                std::set< std::shared_ptr< ConnectionState > > oldConnectionsToDrop(std::move(connectionsToDrop));
-                connectionsToDrop.clear();
-                {
-                    lock.unlock();
-                    oldConnectionsToDrop.clear();
-                    lock.lock();
-                }
-                std::queue< BanDelegateArguments > banDelegateCallArguments;
-                banDelegateCallArguments.swap(queuedBanDelegateCallArguments);
-                const auto banDelegatesCopy = banDelegates;
-                {
-                    lock.unlock();
-                    while (!banDelegateCallArguments.empty()) {
-                        const auto& arguments = banDelegateCallArguments.front();
-                        for (const auto& banDelegate: banDelegatesCopy) {
-                            banDelegate.second(
-                                arguments.peerAddress,
-                                arguments.reason
-                            );
-                        }
-                        banDelegateCallArguments.pop();
-                    }
-                    lock.lock();
-                }
-                reaperWakeCondition.wait(
-                    lock,
-                    [this]{
-                        return (
-                            stopReaper
-                            || !connectionsToDrop.empty()
-                            || !queuedBanDelegateCallArguments.empty()
-                        );
-                    }
+        virtual void SendBodyChunk(const std::string& chunk) override {
+            const auto connectionState = connectionStateWeak.lock();
+            if (connectionState == nullptr) {
+                return;
+            }
+            std::lock_guard< decltype(connectionState->shard->mutex) > lock(connectionState->shard->mutex);
+            if (
+                !headersSent
+                || finished
+                || chunk.empty()
+                || connectionState->serverClosed
+            ) {
+                return;
+            }
+            if (chunked) {
+                const auto chunkHeader = StringExtensions::sprintf(
+                    "%zx\r\n",
+                    chunk.length()
+                );
+                std::vector< Http::Connection::BufferView > chunkBuffers;
+                chunkBuffers.reserve(3);
+                chunkBuffers.emplace_back(
+                    (const uint8_t*)chunkHeader.data(),
+                    chunkHeader.length()
+                );
+                chunkBuffers.emplace_back(
+                    (const uint8_t*)chunk.data(),
+                    chunk.length()
+                );
+                chunkBuffers.emplace_back(
+                    (const uint8_t*)CRLF.data(),
+                    CRLF.length()
+                );
+                connectionState->connection->SendData(chunkBuffers);
+            } else {
+                connectionState->connection->SendData(
+                    std::vector< uint8_t >(chunk.begin(), chunk.end())
                 );
             }
         }
 
-        /**
-         * This method is called one or more times to incrementally parse
-         * a raw HTTP request message.  For the first call, pass in a newly-
-         * constructed request object, and the beginning of the raw
-         * HTTP request message.  Contine calling with the same request
-         * object and subsequent pieces of the raw HTTP request message,
-         * until the request is fully parsed, as indicated by its
-         * requestParsingState transitioning to RequestParsingState::Complete,
-         * RequestParsingState::InvalidRecoverable, or
-         * RequestParsingState::InvalidUnrecoverable.
-         *
-         * @param[in,out] request
-         *     This is the request being parsed.
-         *
-         * @param[in] nextRawRequestPart
-         *     This is the next part of the raw HTTP request message.
-         *
-         * @return
-         *     A count of the number of characters that were taken from
-         *     the given input string is returned. Presumably,
-         *     any characters past this point belong to another message or
-         *     are outside the scope of HTTP.
-         */
-        size_t ParseRequest(
-            Request& request,
-            const std::string& nextRawRequestPart
-        ) {
-            // Count the number of characters incorporated into
-            // the request object.
-            size_t messageEnd = 0;
+        virtual void FinishResponse() override {
+            const auto connectionState = connectionStateWeak.lock();
+            if (connectionState == nullptr) {
+                return;
+            }
+            std::lock_guard< decltype(connectionState->shard->mutex) > lock(connectionState->shard->mutex);
+            if (
+                !headersSent
+                || finished
+            ) {
+                return;
+            }
+            finished = true;
+            if (
+                chunked
+                && !connectionState->serverClosed
+            ) {
+                static const std::string lastChunk("0\r\n\r\n");
+                connectionState->connection->SendData(
+                    std::vector< uint8_t >(lastChunk.begin(), lastChunk.end())
+                );
+            }
+            if (finishedDelegate != nullptr) {
+                finishedDelegate(closeAfterResponse);
+            }
+        }
 
-            // First, extract and parse the request line.
-            if (request.state == Request::State::RequestLine) {
-                const auto requestLineEnd = nextRawRequestPart.find(CRLF);
-                if (requestLineEnd == std::string::npos) {
-                    if (nextRawRequestPart.length() > headerLineLimit) {
-                        request.state = Request::State::Error;
-                        return messageEnd;
-                    }
-                    return messageEnd;
-                }
-                const auto requestLineLength = requestLineEnd;
-                if (requestLineLength > headerLineLimit) {
-                    request.state = Request::State::Error;
-                    return messageEnd;
+        virtual void SetAbandonedDelegate(AbandonedDelegate abandonedDelegate) override {
+            const auto connectionState = connectionStateWeak.lock();
+            if (connectionState == nullptr) {
+                if (abandonedDelegate != nullptr) {
+                    abandonedDelegate();
                 }
-                const auto requestLine = nextRawRequestPart.substr(0, requestLineLength);
-                messageEnd = requestLineEnd + CRLF.length();
-                request.totalBytes = messageEnd;
-                request.state = Request::State::Headers;
-                request.valid = ParseRequestLine(request, requestLine);
+                return;
             }
+            std::lock_guard< decltype(connectionState->shard->mutex) > lock(connectionState->shard->mutex);
+            this->abandonedDelegate = abandonedDelegate;
+        }
 
-            // Second, parse the message headers and identify where the body begins.
-            if (request.state == Request::State::Headers) {
-                request.headers.SetLineLimit(headerLineLimit);
+        virtual size_t GetSendQueueSize() override {
+            const auto connectionState = connectionStateWeak.lock();
+            if (connectionState == nullptr) {
+                return 0;
+            }
+            std::lock_guard< decltype(connectionState->shard->mutex) > lock(connectionState->shard->mutex);
+            return connectionState->connection->GetSendQueueSize();
+        }
+
+        virtual void SetWritableDelegate(WritableDelegate writableDelegate) override {
+            const auto connectionState = connectionStateWeak.lock();
+            if (connectionState == nullptr) {
+                return;
+            }
+            std::lock_guard< decltype(connectionState->shard->mutex) > lock(connectionState->shard->mutex);
+            connectionState->connection->SetWritableDelegate(
+                writableDelegate,
+                sendQueueLowWatermark
+            );
+        }
+    };
+
+    /**
+     * This is the implementation of the request reader interface which
+     * the server hands to streamed request handlers.  It delivers the
+     * body of a claimed request to the handler directly out of the
+     * connection's reassembly buffer, as the body arrives.
+     */
+    struct ServerRequestReader
+        : public Http::IServer::RequestReader
+    {
+        // Properties
+
+        /**
+         * This is the state of the connection on which the body of
+         * the claimed request is arriving.
+         */
+        std::weak_ptr< ConnectionState > connectionStateWeak;
+
+        /**
+         * This is the function to call to deliver each piece of the
+         * request body to the handler.
+         */
+        BodyDelegate bodyDelegate;
+
+        /**
+         * This is the function to call once the entire request body
+         * has been delivered to the handler.
+         */
+        BodyEndDelegate bodyEndDelegate;
+
+        /**
+         * This is the number of characters of the request body which
+         * have not yet been delivered to the handler.
+         */
+        size_t bytesRemaining = 0;
+
+        /**
+         * This flag indicates whether or not the handler has suspended
+         * delivery of the request body.
+         */
+        bool paused = false;
+
+        /**
+         * This flag indicates whether or not the entire request body
+         * has been delivered to the handler.
+         */
+        bool ended = false;
+
+        // Methods
+
+        /**
+         * This method delivers to the handler as much of the request
+         * body as has arrived in the connection's reassembly buffer,
+         * unless delivery is suspended.  Once the entire body has been
+         * delivered, the request is complete, and the reader detaches
+         * itself from the connection.
+         */
+        void DeliverAvailableBody() {
+            const auto connectionState = connectionStateWeak.lock();
+            if (connectionState == nullptr) {
+                return;
+            }
+            std::lock_guard< decltype(connectionState->shard->mutex) > lock(connectionState->shard->mutex);
+            if (ended) {
+                return;
+            }
+            while (
+                !paused
+                && (bytesRemaining > 0)
+                && !connectionState->reassemblyBuffer.IsEmpty()
+                && (bodyDelegate != nullptr)
+            ) {
+                const auto amount = std::min(
+                    bytesRemaining,
+                    connectionState->reassemblyBuffer.Length()
+                );
+                const std::string bodyData(
+                    connectionState->reassemblyBuffer.Data(),
+                    amount
+                );
+                connectionState->reassemblyBuffer.Consume(amount);
+                bytesRemaining -= amount;
+                bodyDelegate(bodyData);
+            }
+            if (bytesRemaining == 0) {
+                ended = true;
+                connectionState->requestReader = nullptr;
+                if (bodyEndDelegate != nullptr) {
+                    bodyEndDelegate();
+                }
+            }
+        }
+
+        // Http::IServer::RequestReader
+
+        virtual void SetBodyDelegate(BodyDelegate bodyDelegate) override {
+            {
+                const auto connectionState = connectionStateWeak.lock();
+                if (connectionState == nullptr) {
+                    return;
+                }
+                std::lock_guard< decltype(connectionState->shard->mutex) > lock(connectionState->shard->mutex);
+                this->bodyDelegate = bodyDelegate;
+            }
+            DeliverAvailableBody();
+        }
+
+        virtual void SetBodyEndDelegate(BodyEndDelegate bodyEndDelegate) override {
+            {
+                const auto connectionState = connectionStateWeak.lock();
+                if (connectionState == nullptr) {
+                    return;
+                }
+                std::lock_guard< decltype(connectionState->shard->mutex) > lock(connectionState->shard->mutex);
+                this->bodyEndDelegate = bodyEndDelegate;
+                if (!ended) {
+                    return;
+                }
+            }
+            bodyEndDelegate();
+        }
+
+        virtual void Pause() override {
+            const auto connectionState = connectionStateWeak.lock();
+            if (connectionState == nullptr) {
+                return;
+            }
+            std::lock_guard< decltype(connectionState->shard->mutex) > lock(connectionState->shard->mutex);
+            paused = true;
+        }
+
+        virtual void Resume() override {
+            {
+                const auto connectionState = connectionStateWeak.lock();
+                if (connectionState == nullptr) {
+                    return;
+                }
+                std::lock_guard< decltype(connectionState->shard->mutex) > lock(connectionState->shard->mutex);
+                paused = false;
+            }
+            DeliverAvailableBody();
+        }
+    };
+
+    /**
+     * This implements a token-bucket rate limiter.  The bucket holds up
+     * to a fixed capacity of tokens, refilled continuously at a fixed
+     * rate, and each permitted event spends one token.  This costs two
+     * doubles of state and constant time per check, no matter how long
+     * the measurement period is.
+     */
+    struct TokenBucket {
+        /**
+         * This is the number of tokens currently in the bucket.
+         * A negative value means the bucket hasn't been used yet,
+         * and will be filled to capacity on first use.
+         */
+        double tokens = -1.0;
+
+        /**
+         * This is a sampling of the time, according to the server's
+         * timekeeper, when tokens were last added to the bucket.
+         */
+        double lastRefillTime = 0.0;
+
+        /**
+         * This method adds to the bucket the tokens accumulated, at the
+         * given rate, since tokens were last added, up to the given
+         * capacity of the bucket.
+         *
+         * @param[in] now
+         *     This is the current time, according to the server's
+         *     timekeeper.
+         *
+         * @param[in] ratePerSecond
+         *     This is the rate at which tokens accumulate in the bucket.
+         *
+         * @param[in] capacity
+         *     This is the maximum number of tokens the bucket can hold.
+         */
+        void Refill(
+            double now,
+            double ratePerSecond,
+            double capacity
+        ) {
+            if (tokens < 0.0) {
+                tokens = capacity;
+            } else {
+                tokens = std::min(
+                    capacity,
+                    tokens + (now - lastRefillTime) * ratePerSecond
+                );
+            }
+            lastRefillTime = now;
+        }
+    };
+
+    /**
+     * This holds information about a client of the web server.
+     */
+    struct ClientDossier {
+        /**
+         * This is the number of seconds that the client will be
+         * ignored, counting from the moment the ban was imposed.
+         */
+        double banPeriod = DEFAULT_BAN_PERIOD_SECONDS;
+
+        /**
+         * This is a sampling of the time, according to the server's
+         * timekeeper, when this client was last banned.
+         */
+        double banStart = 0.0;
+
+        /**
+         * This flag indicates whether or not the client
+         * is currently banned or on probation.
+         */
+        bool banned = false;
+
+        /**
+         * This is the token bucket used to limit the rate of requests
+         * made by the client.  It holds up to TooManyRequestsThreshold
+         * times TooManyRequestsMeasurementPeriod tokens, refilled at
+         * TooManyRequestsThreshold tokens per second, and each request
+         * spends one.
+         */
+        TokenBucket requestBucket;
+
+        /**
+         * This locates the client's entry in the server's queue of
+         * client addresses, ordered from least to most recently seen,
+         * which is used to decide which dossiers to drop when the
+         * dossier store is full.
+         */
+        std::list< std::string >::iterator lruQueueEntry;
+    };
+
+    /**
+     * This holds a response the server has cached, ready to go back
+     * out on the wire without invoking the handler which produced it.
+     */
+    struct ResponseCacheEntry {
+        /**
+         * This is the time, as reported by the server's timekeeper,
+         * after which the cached response is no longer served.
+         */
+        double expiration = 0.0;
+
+        /**
+         * This is the response as produced by the handler, with any
+         * content codings already applied to its body.
+         */
+        Http::Response response;
+
+        /**
+         * This is the status line and headers of the response,
+         * already serialized into their wire form.
+         */
+        std::string head;
+
+        /**
+         * This locates the entry in the server's queue of cached
+         * response keys, ordered from least to most recently served,
+         * which is used to decide which entries to drop when the
+         * cache is over its size limit.
+         */
+        std::list< std::string >::iterator lruQueueEntry;
+    };
+
+    /**
+     * This holds a rejection or error response which the server issues
+     * often enough to keep fully serialized in its wire form, so that
+     * the overload and error paths can send a shared immutable buffer
+     * without building and rendering a response per event.
+     */
+    struct StaticResponse {
+        /**
+         * This is the response, kept alongside the wire form for
+         * metrics, diagnostics, and request reports about its
+         * issuance.
+         */
+        Http::Response response;
+
+        /**
+         * These are the complete wire-form bytes of the response,
+         * status line, headers, and body.
+         */
+        std::string wire;
+    };
+
+    /**
+     * This holds the arguments to pass when calling any registered
+     * ban delegates.
+     */
+    struct BanDelegateArguments {
+        /**
+         * This is the address of the peer whose connections should be banned.
+         */
+        std::string peerAddress;
+
+        /**
+         * This is an explanation of the ban to report through the diagnostics
+         * system.
+         */
+        std::string reason;
+    };
+
+    /**
+     * This holds one diagnostic message waiting to be formatted and
+     * published by the reaper thread, when asynchronous diagnostics
+     * are enabled.
+     */
+    struct QueuedDiagnosticMessage {
+        /**
+         * This is the importance level of the message.
+         */
+        size_t level = 0;
+
+        /**
+         * This is the function to call to render the text of the message.
+         */
+        std::function< std::string() > buildMessage;
+    };
+
+}
+
+namespace Http {
+
+    /**
+     * This contains the private properties of a Server instance.
+     */
+    struct Server::Impl {
+        // Properties
+
+        /**
+         * This refers back to the server whose private properties
+         * are stored here.
+         */
+        Server* server = nullptr;
+
+        /**
+         * This holds all configuration items for the server.
+         */
+        std::map< std::string, std::string > configuration;
+
+        /**
+         * This is the maximum allowed total message size.
+         */
+        size_t maxMessageSize = DEFAULT_MAX_MESSAGE_SIZE;
+
+        /**
+         * This is the maximum number of characters allowed on any header line
+         * of an HTTP request.
+         */
+        size_t headerLineLimit = DEFAULT_HEADER_LINE_LIMIT;
+
+        /**
+         * This is the number of bytes of every bad request to
+         * be reported in diagnostic messages.
+         */
+        size_t badRequestReportBytes = DEFAULT_BAD_REQUEST_REPORT_BYTES;
+
+        /**
+         * This is the public port number to which clients may connect
+         * to establish connections with this server.
+         */
+        uint16_t port = DEFAULT_PORT_NUMBER;
+
+        /**
+         * This is the default maximum number of seconds to allow to elapse
+         * between the end of a request, or the beginning of a connection,
+         * and receiving the first byte of a new client request,
+         * before timing out.
+         */
+        double idleTimeout = DEFAULT_IDLE_TIMEOUT_SECONDS;
+
+        /**
+         * This is the maximum number of seconds to allow to elapse
+         * between receiving one byte of a client request and
+         * receiving the next byte, before timing out.
+         */
+        double inactivityTimeout = DEFAULT_INACTIVITY_TIMEOUT_SECONDS;
+
+        /**
+         * This is the maximum number of seconds to allow to elapse
+         * between initiating a graceful close on connection and
+         * forcing the connection closed ungracefully.
+         */
+        double gracefulCloseTimeout = DEFAULT_GRACEFUL_CLOSE_TIMEOUT_SECONDS;
+
+        /**
+         * This is the maximum number of seconds to allow to elapse
+         * between receiving the first byte of a client request and
+         * receiving the last byte of the request, before timing out.
+         */
+        double requestTimeout = DEFAULT_REQUEST_TIMEOUT_SECONDS;
+
+        /**
+         * This is the amount of time a client should be initially banned
+         * in response to a bad request or too many requests.
+         */
+        double initialBanPeriod = DEFAULT_BAN_PERIOD_SECONDS;
+
+        /**
+         * This is the amount of time required after a client's ban
+         * has been lifted, before the client's ban period will be reset.
+         */
+        double probationPeriod = DEFAULT_PROBATION_PERIOD_SECONDS;
+
+        /**
+         * This is the threshold, in requests per second, after which
+         * a client will be banned.
+         */
+        double tooManyRequestsThreshold = DEFAULT_TOO_MANY_REQUESTS_THRESHOLD;
+
+        /**
+         * This is the period of time over which the number of requests
+         * made by a client is measured.
+         */
+        double tooManyRequestsMeasurementPeriod = DEFAULT_TOO_MANY_REQUESTS_MEASUREMENT_PERIOD;
+
+        /**
+         * This is the threshold, in connect requests per second, after which
+         * new requests will be denied.
+         */
+        double tooManyConnectsThreshold = DEFAULT_TOO_MANY_CONNECTS_THRESHOLD;
+
+        /**
+         * This is the period of time over which the number of connect requests
+         * by clients is measured.
+         */
+        double tooManyConnectsMeasurementPeriod = DEFAULT_TOO_MANY_CONNECTS_MEASUREMENT_PERIOD;
+
+        /**
+         * This flag indicates whether or not the server is running.
+         */
+        bool mobilized = false;
+
+        /**
+         * These are the transport layers currently bound.  They all
+         * share the same port; the first is the one whose bind
+         * determined the port when a port of zero was configured.
+         */
+        std::vector< std::shared_ptr< ServerTransport > > transports;
+
+        /**
+         * This is the object used to track time in the server.
+         */
+        std::shared_ptr< TimeKeeper > timeKeeper;
+
+        /**
+         * This is used to schedule work to be done without having to
+         * poll the timekeeper.
+         */
+        std::unique_ptr< Timekeeping::Scheduler > scheduler;
+
+        /**
+         * This is the wheel used to keep track of connection timeouts.
+         */
+        TimeoutWheel timeoutWheel;
+
+        /**
+         * This is the maximum number of client dossiers to keep.  When
+         * the limit is reached, the dossiers of the least recently seen
+         * unbanned clients are dropped, while the dossiers of banned
+         * clients are kept until their bans and probation have run out.
+         */
+        size_t maxClientDossiers = DEFAULT_MAX_CLIENT_DOSSIERS;
+
+        /**
+         * This holds information about known clients of the server,
+         * keyed by peer address for constant-time lookup.
+         */
+        std::unordered_map< std::string, ClientDossier > clients;
+
+        /**
+         * These are the addresses of the known clients of the server,
+         * ordered from least to most recently seen.
+         */
+        std::list< std::string > dossierLruQueue;
+
+        /**
+         * This is incremented whenever any client dossier is dropped,
+         * invalidating the dossier pointers cached on connections.
+         * It starts at 1 so that a default-constructed connection
+         * generation of zero is always considered stale.
+         */
+        size_t dossierEvictionGeneration = 1;
+
+        /**
+         * This is incremented whenever the acceptlist changes,
+         * invalidating the acceptlist membership flags cached on
+         * connections.  It starts at 1 so that a default-constructed
+         * connection generation of zero is always considered stale.
+         */
+        size_t acceptlistGeneration = 1;
+
+        /**
+         * This is the maximum total number of bytes of serialized
+         * responses for the server to keep in its response cache.
+         * Setting this to zero disables the cache.
+         */
+        size_t responseCacheSize = DEFAULT_RESPONSE_CACHE_SIZE;
+
+        /**
+         * This is the size of a connection's send queue, in bytes, at
+         * or below which a streamed resource handler which paused
+         * sending is told that it may resume.
+         */
+        size_t sendQueueLowWatermark = DEFAULT_SEND_QUEUE_LOW_WATERMARK;
+
+        /**
+         * This holds the responses the server has cached on behalf of
+         * handlers which marked them cacheable, keyed by request
+         * method, target, and accepted encodings.
+         */
+        std::unordered_map< std::string, ResponseCacheEntry > responseCache;
+
+        /**
+         * These are the keys of the cached responses, ordered from
+         * least to most recently served.
+         */
+        std::list< std::string > responseCacheLruQueue;
+
+        /**
+         * These are the pre-serialized rejection and error responses,
+         * keyed by status code and by whether or not the response
+         * carries a "Connection: close" header.  They're built once,
+         * when the server is constructed, since nothing about them
+         * depends on the server's configuration.
+         */
+        std::map< std::pair< unsigned int, bool >, StaticResponse > staticResponses;
+
+        /**
+         * This is the total number of bytes of serialized responses
+         * currently held in the response cache.
+         */
+        size_t responseCacheTotal = 0;
+
+        /**
+         * This holds the addresses of clients that have been "acceptlisted",
+         * or are immune to bans and not checked against rate limits.
+         */
+        std::set< std::string > acceptlist;
+
+        /**
+         * This is the number of independent shards across which
+         * the server partitions its connections.  This may only be
+         * changed before the server is first mobilized.
+         */
+        size_t connectionShards = DEFAULT_CONNECTION_SHARDS;
+
+        /**
+         * These are the shards across which the currently active client
+         * connections are partitioned.  Each shard has its own mutex,
+         * so connections assigned to different shards can be serviced
+         * in parallel.
+         */
+        std::vector< std::shared_ptr< ConnectionShard > > shards;
+
+        /**
+         * These are the client connections that are no longer
+         * managed by the server (because they have either broken or
+         * have been upgraded and are now handled by a resource) and will
+         * be dropped by the reaper thread.
+         */
+        std::set< std::shared_ptr< ConnectionState > > connectionsToDrop;
+
+        /**
+         * This holds the arguments for any ban delegate calls that have
+         * been queued to be called by the reaper thread.
+         */
+        std::queue< BanDelegateArguments > queuedBanDelegateCallArguments;
+
+        /**
+         * This holds all registered ban delegates.
+         */
+        std::map< int, BanDelegate > banDelegates;
+
+        /**
+         * This is the next unique identification number to assign to
+         * a registered ban delegate.
+         */
+        int nextBanDelegateId = 1;
+
+        /**
+         * This is the number of bans the server has imposed on clients.
+         */
+        std::atomic< size_t > bansIssued{0};
+
+        /**
+         * This is a helper object used to generate and publish
+         * diagnostic messages.
+         */
+        SystemAbstractions::DiagnosticsSender diagnosticsSender;
+
+        /**
+         * These are the minimum levels of all current diagnostic message
+         * subscribers, so that the smallest amongst them can be kept
+         * cached in minSubscribedDiagnosticLevel.
+         */
+        std::multiset< size_t > diagnosticSubscriberLevels;
+
+        /**
+         * This is the smallest minimum level amongst all current
+         * diagnostic message subscribers, or NO_DIAGNOSTIC_SUBSCRIBERS if
+         * there are none.  A message below this level has no audience,
+         * so the work of constructing it can be skipped entirely.
+         */
+        std::atomic< size_t > minSubscribedDiagnosticLevel{NO_DIAGNOSTIC_SUBSCRIBERS};
+
+        /**
+         * If not zero, diagnostic messages published on hot request
+         * handling paths are formatted and fanned out to subscribers by
+         * the reaper thread, rather than inline on the path that
+         * generated them.
+         */
+        size_t asyncDiagnostics = 0;
+
+        /**
+         * These are the diagnostic messages waiting to be formatted and
+         * published by the reaper thread, when asynchronous diagnostics
+         * are enabled.
+         */
+        std::queue< QueuedDiagnosticMessage > queuedDiagnosticMessages;
+
+        /**
+         * This is the number of diagnostic messages dropped because too
+         * many messages were already waiting to be published by the
+         * reaper thread.
+         */
+        std::atomic< size_t > diagnosticMessagesDropped{0};
+
+        /**
+         * This is the token bucket used to limit the overall rate of
+         * connection requests made to the server.  It holds up to
+         * TooManyConnectsThreshold times TooManyConnectsMeasurementPeriod
+         * tokens, refilled at TooManyConnectsThreshold tokens per second,
+         * and each accepted connection spends one.
+         */
+        TokenBucket connectBucket;
+
+        /**
+         * This flag indicates whether or not the last connection request
+         * was denied due to exceeding the connection request rate limit.
+         */
+        bool connectRateLimited = false;
+
+        /**
+         * This is a worker thread which clears the connectionsToDrop set
+         * and completes any queued delegate calls.  This prevents deadlocks
+         * since these activities must be done without holding the server's
+         * mutex.
+         */
+        std::thread reaper;
+
+        /**
+         * This flag indicates whether or not the reaper thread should stop.
+         */
+        bool stopReaper = false;
+
+        /**
+         * This represents the entire space of resources under this server.
+         */
+        std::shared_ptr< ResourceSpace > resources;
+
+        /**
+         * This is the compiled form of the resource space tree, rebuilt
+         * whenever a resource is registered or unregistered, and used
+         * to route request paths to handlers without walking the
+         * resource space tree itself.  The first node, if any,
+         * corresponds to the root of the tree.
+         */
+        std::vector< CompiledRouterNode > routerNodes;
+
+        /**
+         * This is used to synchronize access to the cross-cutting state
+         * of the server (configuration, client dossiers, resources, and
+         * the reaper), which isn't partitioned across connection shards.
+         *
+         * To prevent deadlocks, if both this mutex and a shard's mutex
+         * need to be held at the same time, the shard's mutex must
+         * be acquired first.
+         */
+        std::recursive_mutex mutex;
+
+        /**
+         * This is used by the reaper thread to wait on any
+         * condition that it should cause it to wake up.
+         */
+        std::condition_variable_any reaperWakeCondition;
+
+        // Methods
+
+        /**
+         * This is the constructor for the structure.
+         */
+        Impl()
+            : diagnosticsSender("Http::Server")
+        {
+        }
+
+        /**
+         * This is the template of a helper function which is used to
+         * parse a configuration item and set it if the parsing is successful.
+         *
+         * @param ItemType
+         *     This is the type of the configuration item.
+         *
+         * @param[in,out] item
+         *     This is the configuration item to set.
+         *
+         * @param[in] scanFormat
+         *     This is the scanf-style format specification for printing
+         *     the configuration item.
+         *
+         * @param[in] printFormat
+         *     This is the printf-style format specification for printing
+         *     the configuration item.
+         *
+         * @param[in] description
+         *     This is the string to display in diagnostic messages about
+         *     the configuration item.
+         *
+         * @param[in] value
+         *     This is the value to parse to be the new value of the item.
+         */
+        template<
+            typename ItemType
+        > void ParseConfigurationItem(
+            ItemType& item,
+            const char* const scanFormat,
+            const char* const printFormat,
+            const char* const description,
+            const std::string& value
+        ) {
+            ItemType newItem;
+            if (
+                sscanf(
+                    value.c_str(),
+                    scanFormat,
+                    &newItem
+                ) == 1
+            ) {
+                if (item != newItem) {
+                    diagnosticsSender.SendDiagnosticInformationFormatted(
+                        0,
+                        StringExtensions::sprintf(
+                            "%s changed from %s to %s",
+                            description,
+                            printFormat,
+                            printFormat
+                        ).c_str(),
+                        item,
+                        newItem
+                    );
+                    item = newItem;
+                }
+            }
+        }
+
+        /**
+         * This method determines whether or not any diagnostic message
+         * subscriber wants messages of the given level, so that the work
+         * of constructing an unwanted message can be skipped entirely.
+         *
+         * @param[in] level
+         *     This is the importance level of the prospective message.
+         *
+         * @return
+         *     An indication of whether or not any diagnostic message
+         *     subscriber wants messages of the given level is returned.
+         */
+        bool DiagnosticsWanted(size_t level) {
+            return (
+                minSubscribedDiagnosticLevel.load(std::memory_order_relaxed)
+                <= level
+            );
+        }
+
+        /**
+         * This method publishes a diagnostic message whose text is
+         * rendered on demand by the given function.  If no subscriber
+         * wants messages of the given level, the function is never
+         * called.  When asynchronous diagnostics are enabled, the message
+         * is formatted and fanned out to subscribers by the reaper
+         * thread; if too many messages are already waiting for the
+         * reaper, the message is counted and dropped instead.
+         *
+         * @param[in] level
+         *     This is the importance level of the message.
+         *
+         * @param[in] buildMessage
+         *     This is the function to call to render the text of
+         *     the message.
+         */
+        void PublishDiagnostics(
+            size_t level,
+            std::function< std::string() > buildMessage
+        ) {
+            if (!DiagnosticsWanted(level)) {
+                return;
+            }
+            if (asyncDiagnostics != 0) {
+                std::lock_guard< decltype(mutex) > lock(mutex);
+                if (queuedDiagnosticMessages.size() >= MAX_QUEUED_DIAGNOSTIC_MESSAGES) {
+                    diagnosticMessagesDropped.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+                QueuedDiagnosticMessage message;
+                message.level = level;
+                message.buildMessage = std::move(buildMessage);
+                queuedDiagnosticMessages.push(std::move(message));
+                reaperWakeCondition.notify_all();
+            } else {
+                diagnosticsSender.SendDiagnosticInformationString(
+                    level,
+                    buildMessage()
+                );
+            }
+        }
+
+        /**
+         * This method is the body of the reaper thread.
+         * Until it's told to stop, it simply clears
+         * the connectionsToDrop set whenever it wakes up.
+         */
+        void Reaper() {
+            std::unique_lock< decltype(mutex) > lock(mutex);
+            while (!stopReaper) {
+                std::set< std::shared_ptr< ConnectionState > > oldConnectionsToDrop(std::move(connectionsToDrop));
+                connectionsToDrop.clear();
+                {
+                    lock.unlock();
+                    oldConnectionsToDrop.clear();
+                    lock.lock();
+                }
+                std::queue< BanDelegateArguments > banDelegateCallArguments;
+                banDelegateCallArguments.swap(queuedBanDelegateCallArguments);
+                const auto banDelegatesCopy = banDelegates;
+                {
+                    lock.unlock();
+                    while (!banDelegateCallArguments.empty()) {
+                        const auto& arguments = banDelegateCallArguments.front();
+                        for (const auto& banDelegate: banDelegatesCopy) {
+                            banDelegate.second(
+                                arguments.peerAddress,
+                                arguments.reason
+                            );
+                        }
+                        banDelegateCallArguments.pop();
+                    }
+                    lock.lock();
+                }
+                PublishQueuedDiagnosticMessages(lock);
+                reaperWakeCondition.wait(
+                    lock,
+                    [this]{
+                        return (
+                            stopReaper
+                            || !connectionsToDrop.empty()
+                            || !queuedBanDelegateCallArguments.empty()
+                            || !queuedDiagnosticMessages.empty()
+                        );
+                    }
+                );
+            }
+
+            // Publish any diagnostic messages still waiting, so that they
+            // aren't lost when the server is destroyed.
+            PublishQueuedDiagnosticMessages(lock);
+        }
+
+        /**
+         * This method formats and publishes all diagnostic messages
+         * currently waiting for the reaper thread, releasing the given
+         * lock on the server's mutex while the subscribers are called.
+         * If any messages were dropped because too many were waiting,
+         * a summary message is published in their place.
+         *
+         * @param[in,out] lock
+         *     This is the lock held on the server's mutex.
+         */
+        void PublishQueuedDiagnosticMessages(
+            std::unique_lock< decltype(mutex) >& lock
+        ) {
+            std::queue< QueuedDiagnosticMessage > messagesToPublish;
+            messagesToPublish.swap(queuedDiagnosticMessages);
+            const auto messagesDropped = diagnosticMessagesDropped.exchange(
+                0,
+                std::memory_order_relaxed
+            );
+            lock.unlock();
+            while (!messagesToPublish.empty()) {
+                auto& message = messagesToPublish.front();
+                diagnosticsSender.SendDiagnosticInformationString(
+                    message.level,
+                    message.buildMessage()
+                );
+                messagesToPublish.pop();
+            }
+            if (messagesDropped != 0) {
+                diagnosticsSender.SendDiagnosticInformationFormatted(
+                    3,
+                    "Dropped %zu diagnostic message(s) due to backpressure",
+                    messagesDropped
+                );
+            }
+            lock.lock();
+        }
+
+        /**
+         * This method is called one or more times to incrementally parse
+         * a raw HTTP request message.  For the first call, pass in a newly-
+         * constructed request object, and the beginning of the raw
+         * HTTP request message.  Contine calling with the same request
+         * object and subsequent pieces of the raw HTTP request message,
+         * until the request is fully parsed, as indicated by its
+         * requestParsingState transitioning to RequestParsingState::Complete,
+         * RequestParsingState::InvalidRecoverable, or
+         * RequestParsingState::InvalidUnrecoverable.
+         *
+         * @param[in,out] request
+         *     This is the request being parsed.
+         *
+         * @param[in] nextRawRequestPart
+         *     This points to the first character of the next part of
+         *     the raw HTTP request message.
+         *
+         * @param[in] nextRawRequestPartLength
+         *     This is the number of characters in the next part of
+         *     the raw HTTP request message.
+         *
+         * @param[in] stopAfterHeaders
+         *     If this flag is set, parsing stops once the headers of the
+         *     request are complete, leaving any body characters with the
+         *     caller.  This is used to give streamed request handlers
+         *     a chance to claim the request before its body is buffered.
+         *
+         * @return
+         *     A count of the number of characters that were taken from
+         *     the given input span is returned. Presumably,
+         *     any characters past this point belong to another message or
+         *     are outside the scope of HTTP.
+         */
+        size_t ParseRequest(
+            Request& request,
+            const char* nextRawRequestPart,
+            size_t nextRawRequestPartLength,
+            bool stopAfterHeaders = false
+        ) {
+            // Count the number of characters incorporated into
+            // the request object.
+            size_t messageEnd = 0;
+
+            // First, extract and parse the request line.
+            if (request.state == Request::State::RequestLine) {
+                const auto requestLineEnd = FindCRLF(
+                    nextRawRequestPart,
+                    nextRawRequestPartLength
+                );
+                if (requestLineEnd == std::string::npos) {
+                    if (nextRawRequestPartLength > headerLineLimit) {
+                        request.state = Request::State::Error;
+                        return messageEnd;
+                    }
+                    return messageEnd;
+                }
+                const auto requestLineLength = requestLineEnd;
+                if (requestLineLength > headerLineLimit) {
+                    request.state = Request::State::Error;
+                    return messageEnd;
+                }
+                messageEnd = requestLineEnd + CRLF.length();
+                request.totalBytes = messageEnd;
+                request.state = Request::State::Headers;
+                request.valid = ParseRequestLine(
+                    request,
+                    nextRawRequestPart,
+                    requestLineLength
+                );
+            }
+
+            // Second, parse the message headers and identify where the body begins.
+            //
+            // MessageHeaders requires its input in a contiguous string, so
+            // the unparsed headers are the one part of the message which
+            // still has to be copied out of the caller's buffer.  Limit the
+            // copy to the end of the headers, if it's in view, so that any
+            // body characters already received aren't dragged along with it.
+            if (request.state == Request::State::Headers) {
+                request.headers.SetLineLimit(headerLineLimit);
+                const auto headersBegin = nextRawRequestPart + messageEnd;
+                auto headersLength = nextRawRequestPartLength - messageEnd;
+                if (
+                    (headersLength >= CRLF.length())
+                    && (memcmp(headersBegin, CRLF.data(), CRLF.length()) == 0)
+                ) {
+                    headersLength = CRLF.length();
+                } else {
+                    static const std::string doubleCRLF("\r\n\r\n");
+                    const auto headersEnd = std::search(
+                        headersBegin,
+                        headersBegin + headersLength,
+                        doubleCRLF.begin(),
+                        doubleCRLF.end()
+                    );
+                    if (headersEnd != headersBegin + headersLength) {
+                        headersLength = (size_t)(headersEnd - headersBegin) + doubleCRLF.length();
+                    }
+                }
                 size_t headerBytesConsumed;
                 const auto headersState = request.headers.ParseRawMessage(
-                    nextRawRequestPart.substr(messageEnd),
+                    std::string(headersBegin, headersLength),
                     headerBytesConsumed
                 );
-                request.totalBytes += headerBytesConsumed;
-                messageEnd += headerBytesConsumed;
-                if (request.totalBytes > maxMessageSize) {
-                    request.state = Request::State::Error;
-                    request.responseStatusCode = 431;
-                    request.responseReasonPhrase = "Request Header Fields Too Large";
-                    return messageEnd;
-                }
-                switch (headersState) {
-                    case MessageHeaders::MessageHeaders::State::Complete: {
-                        // Done with parsing headers; next will be body.
-                        if (!request.headers.IsValid()) {
-                            request.valid = false;
-                        }
-                        request.state = Request::State::Body;
+                request.totalBytes += headerBytesConsumed;
+                messageEnd += headerBytesConsumed;
+                if (request.totalBytes > maxMessageSize) {
+                    request.state = Request::State::Error;
+                    request.responseStatusCode = 431;
+                    request.responseReasonPhrase = "Request Header Fields Too Large";
+                    return messageEnd;
+                }
+                switch (headersState) {
+                    case MessageHeaders::MessageHeaders::State::Complete: {
+                        // Done with parsing headers; next will be body.
+                        if (!request.headers.IsValid()) {
+                            request.valid = false;
+                        }
+                        request.state = Request::State::Body;
+
+                        // Check for "Host" header.
+                        if (request.headers.HasHeader("Host")) {
+                            const auto requestHost = request.headers.GetHeaderValue("Host");
+                            auto serverHost = configuration["host"];
+                            if (serverHost.empty()) {
+                                serverHost = requestHost;
+                            }
+                            auto targetHost = request.target.GetHost();
+                            if (targetHost.empty()) {
+                                targetHost = serverHost;
+                            }
+                            if (
+                                (requestHost != targetHost)
+                                || (requestHost != serverHost)
+                            ) {
+                                request.valid = false;
+                            }
+                        } else {
+                            request.valid = false;
+                        }
+                    } break;
+
+                    case MessageHeaders::MessageHeaders::State::Incomplete: {
+                    } return messageEnd;
+
+                    case MessageHeaders::MessageHeaders::State::Error:
+                    default: {
+                        request.state = Request::State::Error;
+                        return messageEnd;
+                    }
+                }
+            }
+
+            // Finally, extract the body.
+            if (request.state == Request::State::Body) {
+                if (stopAfterHeaders) {
+                    return messageEnd;
+                }
+                // If there is a "Content-Length"
+                // header, we carefully carve exactly that number of characters
+                // out (and bail if we don't have enough).  Otherwise, we just
+                // assume the body extends to the end of the raw message.
+                const auto bytesAvailableForBody = nextRawRequestPartLength - messageEnd;
+                if (request.headers.HasHeader("Content-Length")) {
+                    intmax_t contentLengthAsInt;
+                    switch (
+                        StringExtensions::ToInteger(
+                            request.headers.GetHeaderValue("Content-Length"),
+                            contentLengthAsInt
+                        )
+                    ) {
+                        case StringExtensions::ToIntegerResult::NotANumber: {
+                            request.state = Request::State::Error;
+                        } return messageEnd;
+
+                        case StringExtensions::ToIntegerResult::Overflow: {
+                            request.state = Request::State::Error;
+                            request.responseStatusCode = 413;
+                            request.responseReasonPhrase = "Payload Too Large";
+                        } return messageEnd;
+
+                        default: break;
+                    }
+                    if (contentLengthAsInt < 0) {
+                        request.state = Request::State::Error;
+                        return messageEnd;
+                    }
+                    request.totalBytes += (size_t)contentLengthAsInt;
+                    if (request.totalBytes > maxMessageSize) {
+                        request.state = Request::State::Error;
+                        request.responseStatusCode = 413;
+                        request.responseReasonPhrase = "Payload Too Large";
+                        return messageEnd;
+                    }
+                    const auto contentLength = (size_t)contentLengthAsInt;
+                    if (contentLength > bytesAvailableForBody) {
+                        request.state = Request::State::Body;
+                        return messageEnd;
+                    } else {
+                        request.body.assign(nextRawRequestPart + messageEnd, contentLength);
+                        messageEnd += contentLength;
+                        request.state = Request::State::Complete;
+                    }
+                } else {
+                    request.body.clear();
+                    request.state = Request::State::Complete;
+                }
+            }
+            return messageEnd;
+        }
+
+        /**
+         * This method is equivalent to the span-based overload above,
+         * for callers which have the raw HTTP request message
+         * in a single string.
+         *
+         * @param[in,out] request
+         *     This is the request being parsed.
+         *
+         * @param[in] nextRawRequestPart
+         *     This is the next part of the raw HTTP request message.
+         *
+         * @return
+         *     A count of the number of characters that were taken from
+         *     the given input string is returned.
+         */
+        size_t ParseRequest(
+            Request& request,
+            const std::string& nextRawRequestPart
+        ) {
+            return ParseRequest(
+                request,
+                nextRawRequestPart.data(),
+                nextRawRequestPart.length()
+            );
+        }
+
+        /**
+         * This method appends the given data to the end of the reassembly
+         * buffer, and then attempts to parse a request out of it.
+         *
+         * @param[in] connectionState
+         *     This is the state of the connection for which to attempt
+         *     to assemble the next request.
+         *
+         * @return
+         *     The request parsed from the reassembly buffer is returned.
+         *
+         * @retval nullptr
+         *     This is returned if no request could be parsed from the
+         *     reassembly buffer.
+         */
+        std::shared_ptr< Request > TryRequestAssembly(
+            std::shared_ptr< ConnectionState > connectionState
+        ) {
+            // If the headers of the request become complete in this pass,
+            // stop there first, so that any registered streamed request
+            // handler gets a chance to claim the request before its body
+            // is buffered.
+            const bool headersWereIncomplete = (
+                (connectionState->nextRequest->state == Request::State::RequestLine)
+                || (connectionState->nextRequest->state == Request::State::Headers)
+            );
+            auto charactersAccepted = ParseRequest(
+                *connectionState->nextRequest,
+                connectionState->reassemblyBuffer.Data(),
+                connectionState->reassemblyBuffer.Length(),
+                headersWereIncomplete
+            );
+            connectionState->reassemblyBuffer.Consume(charactersAccepted);
+            if (
+                headersWereIncomplete
+                && (connectionState->nextRequest->state == Request::State::Body)
+            ) {
+                if (TryClaimRequestBody(connectionState)) {
+                    return nullptr;
+                }
+                charactersAccepted = ParseRequest(
+                    *connectionState->nextRequest,
+                    connectionState->reassemblyBuffer.Data(),
+                    connectionState->reassemblyBuffer.Length()
+                );
+                connectionState->reassemblyBuffer.Consume(charactersAccepted);
+            }
+            if (!connectionState->nextRequest->IsCompleteOrError()) {
+                return nullptr;
+            }
+            const auto request = connectionState->nextRequest;
+            StartNextRequest(connectionState);
+            return request;
+        }
+
+        /**
+         * This method obtains a fresh request object for the given
+         * connection, reusing a spare request object left over from an
+         * earlier request on the same connection, if one is available.
+         *
+         * @param[in] connectionState
+         *     This is the state of the connection for which to obtain
+         *     a fresh request object.
+         *
+         * @return
+         *     A fresh request object is returned.
+         */
+        std::shared_ptr< Request > FetchSpareRequest(
+            std::shared_ptr< ConnectionState > connectionState
+        ) {
+            if (connectionState->spareRequests.empty()) {
+                return std::make_shared< Request >();
+            }
+            auto request = connectionState->spareRequests.back();
+            connectionState->spareRequests.pop_back();
+            return request;
+        }
+
+        /**
+         * This method returns a request object, whose processing is
+         * complete, back to the given connection's spare request pool,
+         * so that a later request on the same connection can reuse it
+         * rather than allocating a new one.  Request objects still
+         * referenced elsewhere (such as by a handler) are left alone.
+         *
+         * @param[in] connectionState
+         *     This is the state of the connection which finished
+         *     processing the request.
+         *
+         * @param[in] request
+         *     This is the request object to return to the pool.
+         */
+        void RecycleRequest(
+            std::shared_ptr< ConnectionState > connectionState,
+            std::shared_ptr< Request > request
+        ) {
+            if (!request.unique()) {
+                return;
+            }
+            *request = Request();
+            if (connectionState->spareRequests.size() < MAX_SPARE_REQUESTS_PER_CONNECTION) {
+                connectionState->spareRequests.push_back(request);
+            }
+        }
+
+        /**
+         * This method determines the time at which the earliest of the
+         * given connection's armed timeouts comes due.
+         *
+         * @param[in] connectionState
+         *     This is the state of the connection whose timeouts
+         *     should be examined.
+         *
+         * @return
+         *     The time at which the earliest of the connection's armed
+         *     timeouts comes due is returned.
+         *
+         * @retval 0.0
+         *     This is returned if the connection has no timeout armed.
+         */
+        double EarliestConnectionTimeoutDue(
+            const std::shared_ptr< ConnectionState >& connectionState
+        ) {
+            auto due = connectionState->idleTimeoutDue;
+            if (
+                (connectionState->inactivityTimeoutDue != 0.0)
+                && (
+                    (due == 0.0)
+                    || (connectionState->inactivityTimeoutDue < due)
+                )
+            ) {
+                due = connectionState->inactivityTimeoutDue;
+            }
+            if (
+                (connectionState->requestTimeoutDue != 0.0)
+                && (
+                    (due == 0.0)
+                    || (connectionState->requestTimeoutDue < due)
+                )
+            ) {
+                due = connectionState->requestTimeoutDue;
+            }
+            return due;
+        }
+
+        /**
+         * This method makes sure the given connection has an entry in
+         * the timeout wheel no later than the slot covering the time
+         * its earliest armed timeout comes due.  If the connection
+         * already has an entry in an earlier slot, it's left alone;
+         * the wheel re-bins the connection when that slot's turn comes
+         * and the timeout isn't yet due.  This keeps pushing a timeout
+         * back (as happens on every read for the inactivity timeout)
+         * from touching the wheel at all.
+         *
+         * @param[in] connectionState
+         *     This is the state of the connection whose timeouts
+         *     should be tracked by the timeout wheel.
+         */
+        void ArmConnectionTimeouts(
+            std::shared_ptr< ConnectionState > connectionState
+        ) {
+            const auto due = EarliestConnectionTimeoutDue(connectionState);
+            if (due == 0.0) {
+                return;
+            }
+            std::lock_guard< std::mutex > lock(timeoutWheel.mutex);
+            auto binTick = (size_t)ceil(due / TIMEOUT_WHEEL_SLOT_WIDTH);
+            binTick = std::max(binTick, timeoutWheel.currentTick + 1);
+            binTick = std::min(binTick, timeoutWheel.currentTick + TIMEOUT_WHEEL_NUM_SLOTS);
+            if (
+                connectionState->inTimeoutWheel
+                && (connectionState->timeoutWheelBinTick <= binTick)
+            ) {
+                return;
+            }
+            timeoutWheel.slots[binTick % TIMEOUT_WHEEL_NUM_SLOTS].push_back(connectionState);
+            connectionState->timeoutWheelBinTick = binTick;
+            connectionState->inTimeoutWheel = true;
+        }
+
+        /**
+         * This method prepares the connection for the next client request.
+         *
+         * @param[in] connectionState
+         *     This is the state of the connection for which to prepare
+         *     the next client request.
+         */
+        void StartNextRequest(
+            std::shared_ptr< ConnectionState > connectionState
+        ) {
+            connectionState->nextRequest = FetchSpareRequest(connectionState);
+            const auto now = timeKeeper->GetCurrentTime();
+            connectionState->requestInProgress = !connectionState->reassemblyBuffer.IsEmpty();
+            if (connectionState->requestInProgress) {
+                connectionState->idleTimeoutDue = 0.0;
+                connectionState->requestTimeoutDue = now + requestTimeout;
+                connectionState->inactivityTimeoutDue = now + inactivityTimeout;
+            } else {
+                connectionState->idleTimeoutDue = now + idleTimeout;
+                connectionState->requestTimeoutDue = 0.0;
+                connectionState->inactivityTimeoutDue = 0.0;
+            }
+            ArmConnectionTimeouts(connectionState);
+            connectionState->timeLastDataReceived = now;
+            connectionState->timeLastRequestStarted = now;
+        }
+
+        /**
+         * This method sends the given response back to the given client.
+         *
+         * @param[in] connectionState
+         *     This is the state of the connection for which to issue
+         *     the given response.
+         *
+         * @param[in] response
+         *     This is the response to send back to the client.
+         *
+         * @param[in] emitDiagnosticMessage
+         *     This flag indicates whether or not to publish a diagnostic
+         *     message about this response being issued.
+         */
+        void IssueResponse(
+            std::shared_ptr< ConnectionState > connectionState,
+            Response& response,
+            bool emitDiagnosticMessage
+        ) {
+            const bool hasFileBody = !response.fileBody.path.empty();
+            if (
+                hasFileBody
+                && !response.headers.HasHeader("Content-Length")
+            ) {
+                response.headers.AddHeader(
+                    "Content-Length",
+                    NumberToString(response.fileBody.length)
+                );
+            }
+            if (
+                !response.headers.HasHeader("Transfer-Encoding")
+                && !response.body.empty()
+                && !response.headers.HasHeader("Content-Length")
+            ) {
+                response.headers.AddHeader(
+                    "Content-Length",
+                    NumberToString(response.body.length())
+                );
+            }
+            auto& responseHead = connectionState->responseHeadBuffer;
+            response.GenerateTo(responseHead);
+            std::vector< Connection::BufferView > responseBuffers;
+            responseBuffers.reserve(2);
+            responseBuffers.emplace_back(
+                (const uint8_t*)responseHead.data(),
+                responseHead.length()
+            );
+            if (
+                !hasFileBody
+                && !response.body.empty()
+            ) {
+                responseBuffers.emplace_back(
+                    (const uint8_t*)response.body.data(),
+                    response.body.length()
+                );
+            }
+            connectionState->connection->SendData(responseBuffers);
+            auto& metrics = connectionState->shard->metrics;
+            size_t bodyBytesSent = response.body.length();
+            if (hasFileBody) {
+                // The headers go out first on their own; the transport
+                // then takes the file region from here, possibly
+                // splicing it onto the connection without ever copying
+                // it through user space.
+                connectionState->connection->SendFile(
+                    response.fileBody.path,
+                    response.fileBody.offset,
+                    response.fileBody.length
+                );
+                bodyBytesSent = response.fileBody.length;
+            }
+            metrics.CountResponse(response.statusCode);
+            metrics.bytesSent.fetch_add(
+                responseHead.length() + bodyBytesSent,
+                std::memory_order_relaxed
+            );
+            if (emitDiagnosticMessage) {
+                diagnosticsSender.SendDiagnosticInformationFormatted(
+                    1, "Sent %u '%s' response back to %s",
+                    response.statusCode,
+                    response.reasonPhrase.c_str(),
+                    connectionState->connection->GetPeerId().c_str()
+                );
+            }
+            HandleResponseClosure(connectionState, response);
+        }
+
+        /**
+         * This method applies the connection-closing policy that goes
+         * with having issued the given response: bad requests get the
+         * client banned and the connection closed, and otherwise the
+         * connection is closed if the response carried a
+         * "Connection: close" header.
+         *
+         * @param[in] connectionState
+         *     This is the state of the connection to which the
+         *     response was issued.
+         *
+         * @param[in] response
+         *     This is the response which was issued.
+         */
+        void HandleResponseClosure(
+            std::shared_ptr< ConnectionState > connectionState,
+            const Response& response
+        ) {
+            bool closeRequested = false;
+            if (
+                (response.statusCode == 400)
+                || (response.statusCode == 413)
+                || (response.statusCode == 431)
+            ) {
+                closeRequested = true;
+                BanHammer(
+                    connectionState->clientAddress,
+                    StringExtensions::sprintf(
+                        "Bad HTTP: %u %s",
+                        response.statusCode,
+                        response.reasonPhrase.c_str()
+                    )
+                );
+            } else {
+                closeRequested = response.headers.HasHeaderToken("Connection", "close");
+            }
+            if (closeRequested) {
+                connectionState->acceptingRequests = false;
+                connectionState->serverClosed = true;
+                OnConnectionBroken(
+                    connectionState,
+                    "closed by server",
+                    ServerConnectionEndHandling::CloseGracefully
+                );
+            }
+        }
 
-                        // Check for "Host" header.
-                        if (request.headers.HasHeader("Host")) {
-                            const auto requestHost = request.headers.GetHeaderValue("Host");
-                            auto serverHost = configuration["host"];
-                            if (serverHost.empty()) {
-                                serverHost = requestHost;
-                            }
-                            auto targetHost = request.target.GetHost();
-                            if (targetHost.empty()) {
-                                targetHost = serverHost;
-                            }
-                            if (
-                                (requestHost != targetHost)
-                                || (requestHost != serverHost)
-                            ) {
-                                request.valid = false;
-                            }
-                        } else {
-                            request.valid = false;
-                        }
-                    } break;
+        /**
+         * This method sends one of the pre-serialized rejection or
+         * error responses back to the given client.  The wire-form
+         * bytes were rendered when the server was constructed, so no
+         * response has to be built or serialized here.
+         *
+         * @param[in] connectionState
+         *     This is the state of the connection for which to issue
+         *     the given response.
+         *
+         * @param[in] staticResponse
+         *     This is the pre-serialized response to issue.
+         *
+         * @param[in] emitDiagnosticMessage
+         *     This flag indicates whether or not to publish a diagnostic
+         *     message about this response being issued.
+         */
+        void IssueStaticResponse(
+            std::shared_ptr< ConnectionState > connectionState,
+            const StaticResponse& staticResponse,
+            bool emitDiagnosticMessage
+        ) {
+            std::vector< Connection::BufferView > responseBuffers;
+            responseBuffers.reserve(1);
+            responseBuffers.emplace_back(
+                (const uint8_t*)staticResponse.wire.data(),
+                staticResponse.wire.length()
+            );
+            connectionState->connection->SendData(responseBuffers);
+            auto& metrics = connectionState->shard->metrics;
+            metrics.CountResponse(staticResponse.response.statusCode);
+            metrics.bytesSent.fetch_add(
+                staticResponse.wire.length(),
+                std::memory_order_relaxed
+            );
+            if (emitDiagnosticMessage) {
+                diagnosticsSender.SendDiagnosticInformationFormatted(
+                    1, "Sent %u '%s' response back to %s",
+                    staticResponse.response.statusCode,
+                    staticResponse.response.reasonPhrase.c_str(),
+                    connectionState->connection->GetPeerId().c_str()
+                );
+            }
+            HandleResponseClosure(connectionState, staticResponse.response);
+        }
 
-                    case MessageHeaders::MessageHeaders::State::Incomplete: {
-                    } return messageEnd;
+        /**
+         * This method builds and serializes one rejection or error
+         * response and adds it to the server's table of static
+         * responses.
+         *
+         * @param[in] statusCode
+         *     This is the status code of the response.
+         *
+         * @param[in] reasonPhrase
+         *     This is the reason phrase of the response.
+         *
+         * @param[in] includeBody
+         *     This flag indicates whether or not to give the response
+         *     the stock plain-text error body.
+         *
+         * @param[in] close
+         *     This flag indicates whether or not to give the response
+         *     a "Connection: close" header.
+         */
+        void AddStaticResponse(
+            unsigned int statusCode,
+            const std::string& reasonPhrase,
+            bool includeBody,
+            bool close
+        ) {
+            StaticResponse staticResponse;
+            auto& response = staticResponse.response;
+            response.statusCode = statusCode;
+            response.reasonPhrase = reasonPhrase;
+            if (includeBody) {
+                response.headers.SetHeader("Content-Type", "text/plain");
+                response.body = "FeelsBadMan\r\n";
+            }
+            if (close) {
+                response.headers.SetHeader("Connection", "close");
+            }
+            if (includeBody) {
+                response.headers.AddHeader(
+                    "Content-Length",
+                    NumberToString(response.body.length())
+                );
+            }
+            response.GenerateTo(staticResponse.wire);
+            staticResponse.wire += response.body;
+            staticResponses[std::make_pair(statusCode, close)] = std::move(staticResponse);
+        }
 
-                    case MessageHeaders::MessageHeaders::State::Error:
-                    default: {
-                        request.state = Request::State::Error;
-                        return messageEnd;
-                    }
-                }
+        /**
+         * This method builds the server's table of pre-serialized
+         * rejection and error responses, so that issuing one later
+         * doesn't require building or rendering a response.
+         */
+        void BuildStaticResponses() {
+            AddStaticResponse(400, "Bad Request", true, false);
+            AddStaticResponse(400, "Bad Request", true, true);
+            AddStaticResponse(404, "Not Found", true, false);
+            AddStaticResponse(404, "Not Found", true, true);
+            AddStaticResponse(408, "Request Timeout", false, true);
+            AddStaticResponse(413, "Payload Too Large", true, false);
+            AddStaticResponse(413, "Payload Too Large", true, true);
+            AddStaticResponse(429, "Too Many Requests", false, true);
+            AddStaticResponse(431, "Request Header Fields Too Large", true, false);
+            AddStaticResponse(431, "Request Header Fields Too Large", true, true);
+        }
+
+        /**
+         * This method looks up the pre-serialized response with the
+         * given status code, if the server has one.
+         *
+         * @param[in] statusCode
+         *     This is the status code of the response to look up.
+         *
+         * @param[in] reasonPhrase
+         *     This is the reason phrase the response is expected
+         *     to have.
+         *
+         * @param[in] close
+         *     This flag indicates whether or not the response should
+         *     carry a "Connection: close" header.
+         *
+         * @return
+         *     The pre-serialized response is returned.
+         *
+         * @retval nullptr
+         *     This is returned if the server has no pre-serialized
+         *     response with the given status code, or its reason
+         *     phrase isn't the expected one, in which case the
+         *     response has to be built and rendered the normal way.
+         */
+        const StaticResponse* FindStaticResponse(
+            unsigned int statusCode,
+            const std::string& reasonPhrase,
+            bool close
+        ) {
+            const auto staticResponsesEntry = staticResponses.find(
+                std::make_pair(statusCode, close)
+            );
+            if (
+                (staticResponsesEntry == staticResponses.end())
+                || (staticResponsesEntry->second.response.reasonPhrase != reasonPhrase)
+            ) {
+                return nullptr;
             }
+            return &staticResponsesEntry->second;
+        }
 
-            // Finally, extract the body.
-            if (request.state == Request::State::Body) {
-                // If there is a "Content-Length"
-                // header, we carefully carve exactly that number of characters
-                // out (and bail if we don't have enough).  Otherwise, we just
-                // assume the body extends to the end of the raw message.
-                const auto bytesAvailableForBody = nextRawRequestPart.length() - messageEnd;
-                if (request.headers.HasHeader("Content-Length")) {
-                    intmax_t contentLengthAsInt;
-                    switch (
-                        StringExtensions::ToInteger(
-                            request.headers.GetHeaderValue("Content-Length"),
-                            contentLengthAsInt
-                        )
-                    ) {
-                        case StringExtensions::ToIntegerResult::NotANumber: {
-                            request.state = Request::State::Error;
-                        } return messageEnd;
+        /**
+         * This method sends a request timeout response back to the given
+         * client.
+         *
+         * @param[in] connectionState
+         *     This is the state of the connection for which to issue
+         *     the given response.
+         */
+        void IssueTimeoutResponse(
+            std::shared_ptr< ConnectionState > connectionState
+        ) {
+            IssueStaticResponse(
+                connectionState,
+                *FindStaticResponse(408, "Request Timeout", true),
+                true
+            );
+        }
 
-                        case StringExtensions::ToIntegerResult::Overflow: {
-                            request.state = Request::State::Error;
-                            request.responseStatusCode = 413;
-                            request.responseReasonPhrase = "Payload Too Large";
-                        } return messageEnd;
+        /**
+         * This method schedules the callback which advances the timeout
+         * wheel once the time covered by the wheel's next slot has passed.
+         */
+        void ScheduleTimeoutWheelTick() {
+            if (scheduler == nullptr) {
+                return;
+            }
+            scheduler->Schedule(
+                [this]{ AdvanceTimeoutWheel(); },
+                (double)(timeoutWheel.currentTick + 1) * TIMEOUT_WHEEL_SLOT_WIDTH
+            );
+        }
 
-                        default: break;
-                    }
-                    if (contentLengthAsInt < 0) {
-                        request.state = Request::State::Error;
-                        return messageEnd;
-                    }
-                    request.totalBytes += (size_t)contentLengthAsInt;
-                    if (request.totalBytes > maxMessageSize) {
-                        request.state = Request::State::Error;
-                        request.responseStatusCode = 413;
-                        request.responseReasonPhrase = "Payload Too Large";
-                        return messageEnd;
-                    }
-                    const auto contentLength = (size_t)contentLengthAsInt;
-                    if (contentLength > bytesAvailableForBody) {
-                        request.state = Request::State::Body;
-                        return messageEnd;
-                    } else {
-                        request.body = nextRawRequestPart.substr(messageEnd, contentLength);
-                        messageEnd += contentLength;
-                        request.state = Request::State::Complete;
-                    }
+        /**
+         * This method advances the timeout wheel up to the current time,
+         * timing out the connections binned in the slots whose turns
+         * have passed, and schedules the wheel's next advance.  A binned
+         * connection whose earliest timeout isn't yet due (because the
+         * timeout was pushed back or disarmed after the connection was
+         * binned, or because it was due beyond the wheel's horizon) is
+         * re-binned or dropped as appropriate.
+         */
+        void AdvanceTimeoutWheel() {
+            const auto timeKeeperLocal = timeKeeper;
+            if (timeKeeperLocal == nullptr) {
+                return;
+            }
+            const auto now = timeKeeperLocal->GetCurrentTime();
+            std::vector< std::weak_ptr< ConnectionState > > binnedConnections;
+            size_t drainedThroughTick;
+            {
+                std::lock_guard< std::mutex > lock(timeoutWheel.mutex);
+                while ((double)(timeoutWheel.currentTick + 1) * TIMEOUT_WHEEL_SLOT_WIDTH <= now) {
+                    ++timeoutWheel.currentTick;
+                    auto& slot = timeoutWheel.slots[timeoutWheel.currentTick % TIMEOUT_WHEEL_NUM_SLOTS];
+                    binnedConnections.insert(
+                        binnedConnections.end(),
+                        slot.begin(),
+                        slot.end()
+                    );
+                    slot.clear();
+                }
+                drainedThroughTick = timeoutWheel.currentTick;
+            }
+            for (const auto& connectionStateWeak: binnedConnections) {
+                const auto connectionState = connectionStateWeak.lock();
+                if (connectionState == nullptr) {
+                    continue;
+                }
+                std::lock_guard< decltype(connectionState->shard->mutex) > lock(connectionState->shard->mutex);
+                if (
+                    !connectionState->inTimeoutWheel
+                    || (connectionState->timeoutWheelBinTick > drainedThroughTick)
+                ) {
+                    // This entry is stale: the connection was binned
+                    // again, into some other slot, after this entry
+                    // was made.
+                    continue;
+                }
+                connectionState->inTimeoutWheel = false;
+                const auto due = EarliestConnectionTimeoutDue(connectionState);
+                if (due == 0.0) {
+                    continue;
+                }
+                if (due <= now) {
+                    SuspendConnectionTimeouts(connectionState);
+                    IssueTimeoutResponse(connectionState);
                 } else {
-                    request.body.clear();
-                    request.state = Request::State::Complete;
+                    ArmConnectionTimeouts(connectionState);
                 }
             }
-            return messageEnd;
+            ScheduleTimeoutWheelTick();
         }
 
         /**
-         * This method appends the given data to the end of the reassembly
-         * buffer, and then attempts to parse a request out of it.
+         * This method drops the dossiers of the least recently seen
+         * clients until the dossier store is back within its capacity.
+         * The dossiers of banned clients are not dropped until their
+         * bans and probation have run out.  The dossier of the most
+         * recently seen client is never dropped.
+         *
+         * @note
+         *     The server's mutex must be held when calling this method.
+         */
+        void EvictClientDossiers() {
+            if (timeKeeper == nullptr) {
+                return;
+            }
+            const auto now = timeKeeper->GetCurrentTime();
+            bool anyDossiersEvicted = false;
+            auto lruQueueEntry = dossierLruQueue.begin();
+            while (
+                (clients.size() > maxClientDossiers)
+                && (lruQueueEntry != dossierLruQueue.end())
+                && (std::next(lruQueueEntry) != dossierLruQueue.end())
+            ) {
+                const auto clientsEntry = clients.find(*lruQueueEntry);
+                const auto& client = clientsEntry->second;
+                if (
+                    client.banned
+                    && (now < client.banStart + client.banPeriod + probationPeriod)
+                ) {
+                    ++lruQueueEntry;
+                    continue;
+                }
+                (void)clients.erase(clientsEntry);
+                lruQueueEntry = dossierLruQueue.erase(lruQueueEntry);
+                anyDossiersEvicted = true;
+            }
+            if (anyDossiersEvicted) {
+                ++dossierEvictionGeneration;
+            }
+        }
+
+        /**
+         * This method looks up the dossier the server holds about the
+         * client at the given address, creating a new one if the client
+         * hasn't been seen before, and marks the client as the most
+         * recently seen.  If creating the dossier pushes the store past
+         * its capacity, the dossiers of the least recently seen
+         * unbanned clients are dropped.
+         *
+         * @note
+         *     The server's mutex must be held when calling this method.
+         *
+         * @param[in] clientAddress
+         *     This is the address of the client whose dossier to look up.
+         *
+         * @return
+         *     The dossier held about the given client is returned.
+         */
+        ClientDossier& FetchClientDossier(const std::string& clientAddress) {
+            auto clientsEntry = clients.find(clientAddress);
+            if (clientsEntry == clients.end()) {
+                clientsEntry = clients.insert({clientAddress, ClientDossier()}).first;
+                clientsEntry->second.lruQueueEntry = dossierLruQueue.insert(
+                    dossierLruQueue.end(),
+                    clientAddress
+                );
+                EvictClientDossiers();
+            } else {
+                dossierLruQueue.splice(
+                    dossierLruQueue.end(),
+                    dossierLruQueue,
+                    clientsEntry->second.lruQueueEntry
+                );
+            }
+            return clientsEntry->second;
+        }
+
+        /**
+         * This method looks up the dossier the server holds about the
+         * client at the other end of the given connection, and marks
+         * the client as the most recently seen.  The dossier pointer
+         * is cached on the connection, so that subsequent lookups for
+         * the same connection don't have to hash the client's address,
+         * until any dossier is dropped from the store.
+         *
+         * @note
+         *     The server's mutex must be held when calling this method.
          *
          * @param[in] connectionState
-         *     This is the state of the connection for which to attempt
-         *     to assemble the next request.
+         *     This is the state of the connection from the client
+         *     whose dossier to look up.
+         *
+         * @return
+         *     The dossier held about the client at the other end of
+         *     the given connection is returned.
+         */
+        ClientDossier& FetchConnectionDossier(
+            const std::shared_ptr< ConnectionState >& connectionState
+        ) {
+            if (
+                (connectionState->dossier != nullptr)
+                && (connectionState->dossierGeneration == dossierEvictionGeneration)
+            ) {
+                auto& client = *connectionState->dossier;
+                dossierLruQueue.splice(
+                    dossierLruQueue.end(),
+                    dossierLruQueue,
+                    client.lruQueueEntry
+                );
+                return client;
+            }
+            auto& client = FetchClientDossier(connectionState->clientAddress);
+            connectionState->dossier = &client;
+            connectionState->dossierGeneration = dossierEvictionGeneration;
+            return client;
+        }
+
+        /**
+         * This method determines whether or not the client at the
+         * other end of the given connection is on the server's
+         * acceptlist.  The answer is cached on the connection, so that
+         * subsequent checks for the same connection don't have to
+         * search the acceptlist, until the acceptlist changes.
+         *
+         * @note
+         *     The server's mutex must be held when calling this method.
+         *
+         * @param[in] connectionState
+         *     This is the state of the connection from the client
+         *     to check against the acceptlist.
+         *
+         * @return
+         *     An indication of whether or not the client at the other
+         *     end of the given connection is on the server's
+         *     acceptlist is returned.
+         */
+        bool IsAcceptlisted(
+            const std::shared_ptr< ConnectionState >& connectionState
+        ) {
+            if (connectionState->acceptlistGeneration != acceptlistGeneration) {
+                connectionState->acceptlisted = (
+                    acceptlist.find(connectionState->clientAddress)
+                    != acceptlist.end()
+                );
+                connectionState->acceptlistGeneration = acceptlistGeneration;
+            }
+            return connectionState->acceptlisted;
+        }
+
+        /**
+         * This method forms the key under which a response to the
+         * given request would be held in the response cache.
+         *
+         * @param[in] request
+         *     This is the request whose response cache key to form.
+         *
+         * @param[in] target
+         *     This is the target of the request, rendered as a string.
+         *
+         * @return
+         *     The key under which a response to the given request
+         *     would be held in the response cache is returned.
+         */
+        std::string MakeResponseCacheKey(
+            const Request& request,
+            const std::string& target
+        ) {
+            return (
+                request.method
+                + ' '
+                + target
+                + '\n'
+                + request.headers.GetHeaderValue("Accept-Encoding")
+            );
+        }
+
+        /**
+         * This method drops the given entry from the response cache.
          *
-         * @return
-         *     The request parsed from the reassembly buffer is returned.
+         * @note
+         *     The server's mutex must be held when calling this method.
          *
-         * @retval nullptr
-         *     This is returned if no request could be parsed from the
-         *     reassembly buffer.
+         * @param[in] responseCacheEntry
+         *     This is the entry to drop from the response cache.
          */
-        std::shared_ptr< Request > TryRequestAssembly(
-            std::shared_ptr< ConnectionState > connectionState
+        void DropCachedResponse(
+            std::unordered_map< std::string, ResponseCacheEntry >::iterator responseCacheEntry
         ) {
-            const auto charactersAccepted = ParseRequest(
-                *connectionState->nextRequest,
-                connectionState->reassemblyBuffer
-            );
-            connectionState->reassemblyBuffer.erase(
-                connectionState->reassemblyBuffer.begin(),
-                connectionState->reassemblyBuffer.begin() + charactersAccepted
+            responseCacheTotal -= (
+                responseCacheEntry->second.head.length()
+                + responseCacheEntry->second.response.body.length()
             );
-            if (!connectionState->nextRequest->IsCompleteOrError()) {
-                return nullptr;
-            }
-            const auto request = connectionState->nextRequest;
-            StartNextRequest(connectionState);
-            return request;
+            (void)responseCacheLruQueue.erase(responseCacheEntry->second.lruQueueEntry);
+            (void)responseCache.erase(responseCacheEntry);
         }
 
         /**
-         * This method prepares the connection for the next client request.
+         * This method looks up the response cache for a response
+         * ready to be served for the given request, counting the
+         * lookup as a hit or a miss.
          *
-         * @param[in] connectionState
-         *     This is the state of the connection for which to prepare
-         *     the next client request.
+         * @note
+         *     The server's mutex must be held when calling this method.
+         *
+         * @param[in] request
+         *     This is the request for which to look up a cached response.
+         *
+         * @param[in] target
+         *     This is the target of the request, rendered as a string.
+         *
+         * @param[in,out] metrics
+         *     These are the metrics of the shard holding the connection
+         *     on which the request was made, against which to count
+         *     the lookup.
+         *
+         * @return
+         *     The cached response ready to be served for the given
+         *     request is returned.
+         *
+         * @retval nullptr
+         *     This is returned if no cached response can be served
+         *     for the given request.
          */
-        void StartNextRequest(
-            std::shared_ptr< ConnectionState > connectionState
+        const ResponseCacheEntry* FetchCachedResponse(
+            const Request& request,
+            const std::string& target,
+            ShardMetrics& metrics
         ) {
-            connectionState->nextRequest = std::make_shared< Request >();
-            const auto now = timeKeeper->GetCurrentTime();
-            connectionState->requestInProgress = !connectionState->reassemblyBuffer.empty();
-            if (connectionState->idleTimeoutToken != 0) {
-                scheduler->Cancel(connectionState->idleTimeoutToken);
-                connectionState->idleTimeoutToken = 0;
-            }
-            if (connectionState->inactivityTimeoutToken != 0) {
-                scheduler->Cancel(connectionState->inactivityTimeoutToken);
-                connectionState->inactivityTimeoutToken = 0;
+            if (responseCacheSize == 0) {
+                return nullptr;
             }
-            if (connectionState->requestTimeoutToken != 0) {
-                scheduler->Cancel(connectionState->requestTimeoutToken);
-                connectionState->requestTimeoutToken = 0;
+            if (request.headers.HasHeaderToken("Connection", "close")) {
+                // The response to the final request on a connection
+                // carries an extra "Connection" header, so it can't
+                // be served from (or stored in) the cache.
+                return nullptr;
             }
-            std::weak_ptr< ConnectionState > connectionStateWeak(connectionState);
-            const auto timeoutCallback = [
-                this,
-                connectionStateWeak
-            ]{
-                auto connectionState = connectionStateWeak.lock();
-                if (connectionState != nullptr) {
-                    IssueTimeoutResponse(connectionState);
+            const auto responseCacheEntry = responseCache.find(
+                MakeResponseCacheKey(request, target)
+            );
+            if (responseCacheEntry != responseCache.end()) {
+                if (timeKeeper->GetCurrentTime() < responseCacheEntry->second.expiration) {
+                    metrics.responseCacheHits.fetch_add(1, std::memory_order_relaxed);
+                    responseCacheLruQueue.splice(
+                        responseCacheLruQueue.end(),
+                        responseCacheLruQueue,
+                        responseCacheEntry->second.lruQueueEntry
+                    );
+                    return &responseCacheEntry->second;
                 }
-            };
-            if (connectionState->requestInProgress) {
-                connectionState->requestTimeoutToken = scheduler->Schedule(
-                    timeoutCallback,
-                    now + requestTimeout
-                );
-                connectionState->inactivityTimeoutToken = scheduler->Schedule(
-                    timeoutCallback,
-                    now + inactivityTimeout
-                );
-            } else {
-                connectionState->idleTimeoutToken = scheduler->Schedule(
-                    timeoutCallback,
-                    now + idleTimeout
-                );
+                DropCachedResponse(responseCacheEntry);
             }
-            connectionState->timeLastDataReceived = now;
-            connectionState->timeLastRequestStarted = now;
+            metrics.responseCacheMisses.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
         }
 
         /**
-         * This method sends the given response back to the given client.
+         * This method stores the given response in the response cache,
+         * if the handler marked it cacheable (with a "Cache-Control"
+         * header having a positive "max-age" directive), dropping the
+         * least recently served entries to bring the cache back within
+         * its size limit.  The response is stored with its headers
+         * already serialized and its content codings already applied,
+         * so that serving it is a single buffered write.
          *
-         * @param[in] connectionState
-         *     This is the state of the connection for which to issue
-         *     the given response.
+         * @note
+         *     The server's mutex must be held when calling this method.
          *
-         * @param[in] response
-         *     This is the response to send back to the client.
+         * @param[in] request
+         *     This is the request for which the response was produced.
          *
-         * @param[in] emitDiagnosticMessage
-         *     This flag indicates whether or not to publish a diagnostic
-         *     message about this response being issued.
+         * @param[in] target
+         *     This is the target of the request, rendered as a string.
+         *
+         * @param[in] response
+         *     This is the response to store in the response cache.
          */
-        void IssueResponse(
-            std::shared_ptr< ConnectionState > connectionState,
-            Response& response,
-            bool emitDiagnosticMessage
+        void StoreResponseInCache(
+            const Request& request,
+            const std::string& target,
+            const Response& response
         ) {
+            if (
+                (responseCacheSize == 0)
+                || (response.statusCode != 200)
+                || response.headers.HasHeader("Connection")
+                || !response.fileBody.path.empty()
+            ) {
+                return;
+            }
+            double maxAge = 0.0;
+            for (const auto& token: response.headers.GetHeaderTokens("Cache-Control")) {
+                if (sscanf(token.c_str(), "max-age=%lf", &maxAge) == 1) {
+                    break;
+                }
+            }
+            if (maxAge <= 0.0) {
+                return;
+            }
+            const auto key = MakeResponseCacheKey(request, target);
+            const auto oldResponseCacheEntry = responseCache.find(key);
+            if (oldResponseCacheEntry != responseCache.end()) {
+                DropCachedResponse(oldResponseCacheEntry);
+            }
+            ResponseCacheEntry newResponseCacheEntry;
+            newResponseCacheEntry.expiration = timeKeeper->GetCurrentTime() + maxAge;
+            newResponseCacheEntry.response = response;
             if (
                 !response.headers.HasHeader("Transfer-Encoding")
                 && !response.body.empty()
                 && !response.headers.HasHeader("Content-Length")
             ) {
-                response.headers.AddHeader(
+                newResponseCacheEntry.response.headers.AddHeader(
                     "Content-Length",
-                    StringExtensions::sprintf("%zu", response.body.length())
+                    NumberToString(response.body.length())
                 );
             }
-            const auto responseText = response.Generate();
-            connectionState->connection->SendData(
-                std::vector< uint8_t >(
-                    responseText.begin(),
-                    responseText.end()
-                )
+            newResponseCacheEntry.response.GenerateTo(newResponseCacheEntry.head);
+            const auto entrySize = (
+                newResponseCacheEntry.head.length()
+                + newResponseCacheEntry.response.body.length()
             );
-            if (emitDiagnosticMessage) {
-                diagnosticsSender.SendDiagnosticInformationFormatted(
-                    1, "Sent %u '%s' response back to %s",
-                    response.statusCode,
-                    response.reasonPhrase.c_str(),
-                    connectionState->connection->GetPeerId().c_str()
-                );
-            }
-            bool closeRequested = false;
-            if (
-                (response.statusCode == 400)
-                || (response.statusCode == 413)
-                || (response.statusCode == 431)
-            ) {
-                closeRequested = true;
-                const auto clientAddress = connectionState->connection->GetPeerAddress();
-                BanHammer(
-                    clientAddress,
-                    StringExtensions::sprintf(
-                        "Bad HTTP: %u %s",
-                        response.statusCode,
-                        response.reasonPhrase.c_str()
-                    )
-                );
-            } else {
-                closeRequested = response.headers.HasHeaderToken("Connection", "close");
+            if (entrySize > responseCacheSize) {
+                return;
             }
-            if (closeRequested) {
-                connectionState->acceptingRequests = false;
-                connectionState->serverClosed = true;
-                OnConnectionBroken(
-                    connectionState,
-                    "closed by server",
-                    ServerConnectionEndHandling::CloseGracefully
+            while (responseCacheTotal + entrySize > responseCacheSize) {
+                DropCachedResponse(
+                    responseCache.find(responseCacheLruQueue.front())
                 );
             }
+            const auto responseCacheEntry = responseCache.insert(
+                {key, std::move(newResponseCacheEntry)}
+            ).first;
+            responseCacheEntry->second.lruQueueEntry = responseCacheLruQueue.insert(
+                responseCacheLruQueue.end(),
+                responseCacheEntry->first
+            );
+            responseCacheTotal += entrySize;
         }
 
         /**
-         * This method sends a request timeout response back to the given
-         * client.
+         * This method sends the given cached response back to the
+         * given client.
          *
          * @param[in] connectionState
-         *     This is the state of the connection for which to issue
-         *     the given response.
+         *     This is the state of the connection for which to serve
+         *     the cached response.
+         *
+         * @param[in] responseCacheEntry
+         *     This is the cached response to serve.
          */
-        void IssueTimeoutResponse(
-            std::shared_ptr< ConnectionState > connectionState
+        void SendCachedResponse(
+            std::shared_ptr< ConnectionState > connectionState,
+            const ResponseCacheEntry& responseCacheEntry
         ) {
-            const auto response = std::make_shared< Response >();
-            response->statusCode = 408;
-            response->reasonPhrase = "Request Timeout";
-            response->headers.AddHeader("Connection", "close");
-            IssueResponse(connectionState, *response, true);
+            std::vector< Connection::BufferView > responseBuffers;
+            responseBuffers.reserve(2);
+            responseBuffers.emplace_back(
+                (const uint8_t*)responseCacheEntry.head.data(),
+                responseCacheEntry.head.length()
+            );
+            if (!responseCacheEntry.response.body.empty()) {
+                responseBuffers.emplace_back(
+                    (const uint8_t*)responseCacheEntry.response.body.data(),
+                    responseCacheEntry.response.body.length()
+                );
+            }
+            connectionState->connection->SendData(responseBuffers);
+            auto& metrics = connectionState->shard->metrics;
+            metrics.CountResponse(responseCacheEntry.response.statusCode);
+            metrics.bytesSent.fetch_add(
+                responseCacheEntry.head.length() + responseCacheEntry.response.body.length(),
+                std::memory_order_relaxed
+            );
         }
 
         /**
@@ -1105,36 +3272,55 @@ namespace Http {
             const std::string& clientAddress,
             const std::string& reason
         ) {
+            std::lock_guard< decltype(mutex) > lock(mutex);
             if (acceptlist.find(clientAddress) != acceptlist.end()) {
-                diagnosticsSender.SendDiagnosticInformationFormatted(
-                    3, "Request: %s would have been banned (%s), but is acceptlisted",
-                    clientAddress.c_str(),
-                    reason.c_str()
+                PublishDiagnostics(
+                    3,
+                    [clientAddress, reason]{
+                        return StringExtensions::sprintf(
+                            "Request: %s would have been banned (%s), but is acceptlisted",
+                            clientAddress.c_str(),
+                            reason.c_str()
+                        );
+                    }
                 );
                 return;
             }
+            bansIssued.fetch_add(1, std::memory_order_relaxed);
             BanDelegateArguments banDelegateArguments;
             banDelegateArguments.peerAddress = clientAddress;
             banDelegateArguments.reason = reason;
             queuedBanDelegateCallArguments.push(banDelegateArguments);
             reaperWakeCondition.notify_all();
             const auto now = timeKeeper->GetCurrentTime();
-            auto& client = clients[clientAddress];
+            auto& client = FetchClientDossier(clientAddress);
             if (client.banned) {
                 client.banPeriod *= 2.0;
-                diagnosticsSender.SendDiagnosticInformationFormatted(
-                    3, "Request: %s ban extended to %lg seconds (%s)",
-                    clientAddress.c_str(),
-                    client.banPeriod,
-                    reason.c_str()
+                const auto banPeriod = client.banPeriod;
+                PublishDiagnostics(
+                    3,
+                    [clientAddress, banPeriod, reason]{
+                        return StringExtensions::sprintf(
+                            "Request: %s ban extended to %lg seconds (%s)",
+                            clientAddress.c_str(),
+                            banPeriod,
+                            reason.c_str()
+                        );
+                    }
                 );
             } else {
                 client.banPeriod = initialBanPeriod;
-                diagnosticsSender.SendDiagnosticInformationFormatted(
-                    3, "Request: %s banned for %lg seconds (%s)",
-                    clientAddress.c_str(),
-                    client.banPeriod,
-                    reason.c_str()
+                const auto banPeriod = client.banPeriod;
+                PublishDiagnostics(
+                    3,
+                    [clientAddress, banPeriod, reason]{
+                        return StringExtensions::sprintf(
+                            "Request: %s banned for %lg seconds (%s)",
+                            clientAddress.c_str(),
+                            banPeriod,
+                            reason.c_str()
+                        );
+                    }
                 );
             }
             client.banStart = now;
@@ -1163,36 +3349,63 @@ namespace Http {
             const std::string& target,
             const std::string& peerId
         ) {
-            diagnosticsSender.SendDiagnosticInformationFormatted(
-                1, "Request: %s '%s' (%s) from %s: %u (%s)",
-                request.method.c_str(),
-                target.c_str(),
-                (
-                    request.headers.HasHeader("Content-Type")
-                    ? StringExtensions::sprintf(
-                        "%s:%zu",
-                        request.headers.GetHeaderValue("Content-Type").c_str(),
-                        request.body.length()
-                    ).c_str()
-                    : StringExtensions::sprintf(
-                        "%zu",
-                        request.body.length()
-                    ).c_str()
-                ),
-                peerId.c_str(),
-                response.statusCode,
-                (
-                    response.headers.HasHeader("Content-Type")
-                    ? StringExtensions::sprintf(
-                        "%s:%zu",
-                        response.headers.GetHeaderValue("Content-Type").c_str(),
-                        response.body.length()
-                    ).c_str()
-                    : StringExtensions::sprintf(
-                        "%zu",
-                        response.body.length()
-                    ).c_str()
-                )
+            if (!DiagnosticsWanted(1)) {
+                return;
+            }
+            const auto method = request.method;
+            const auto requestContentType = request.headers.GetHeaderValue("Content-Type");
+            const bool requestHasContentType = request.headers.HasHeader("Content-Type");
+            const auto requestBodyLength = request.body.length();
+            const auto statusCode = response.statusCode;
+            const auto responseContentType = response.headers.GetHeaderValue("Content-Type");
+            const bool responseHasContentType = response.headers.HasHeader("Content-Type");
+            const auto responseBodyLength = response.body.length();
+            PublishDiagnostics(
+                1,
+                [
+                    method,
+                    target,
+                    requestContentType,
+                    requestHasContentType,
+                    requestBodyLength,
+                    peerId,
+                    statusCode,
+                    responseContentType,
+                    responseHasContentType,
+                    responseBodyLength
+                ]{
+                    return StringExtensions::sprintf(
+                        "Request: %s '%s' (%s) from %s: %u (%s)",
+                        method.c_str(),
+                        target.c_str(),
+                        (
+                            requestHasContentType
+                            ? StringExtensions::sprintf(
+                                "%s:%zu",
+                                requestContentType.c_str(),
+                                requestBodyLength
+                            ).c_str()
+                            : StringExtensions::sprintf(
+                                "%zu",
+                                requestBodyLength
+                            ).c_str()
+                        ),
+                        peerId.c_str(),
+                        statusCode,
+                        (
+                            responseHasContentType
+                            ? StringExtensions::sprintf(
+                                "%s:%zu",
+                                responseContentType.c_str(),
+                                responseBodyLength
+                            ).c_str()
+                            : StringExtensions::sprintf(
+                                "%zu",
+                                responseBodyLength
+                            ).c_str()
+                        )
+                    );
+                }
             );
         }
 
@@ -1220,6 +3433,13 @@ namespace Http {
                 connectionState->connection->GetPeerId().c_str(),
                 reason.c_str()
             );
+            if (connectionState->abandonStreamedResponse != nullptr) {
+                const auto abandonStreamedResponse = connectionState->abandonStreamedResponse;
+                connectionState->abandonStreamedResponse = nullptr;
+                connectionState->streamedResponseInProgress = false;
+                connectionState->requestReader = nullptr;
+                abandonStreamedResponse();
+            }
             switch (serverConnectionEndHandling) {
                 case ServerConnectionEndHandling::CloseGracefully: {
                     connectionState->connection->Break(true);
@@ -1247,13 +3467,371 @@ namespace Http {
                     );
                 } break;
 
-                case ServerConnectionEndHandling::CloseAbruptly: {
-                    connectionState->connection->Break(false);
-                    (void)connectionsToDrop.insert(connectionState);
-                    reaperWakeCondition.notify_all();
-                    (void)activeConnections.erase(connectionState);
-                } break;
+                case ServerConnectionEndHandling::CloseAbruptly: {
+                    connectionState->connection->Break(false);
+                    {
+                        std::lock_guard< decltype(mutex) > lock(mutex);
+                        (void)connectionsToDrop.insert(connectionState);
+                        reaperWakeCondition.notify_all();
+                    }
+                    (void)connectionState->shard->activeConnections.erase(connectionState);
+                } break;
+            }
+        }
+
+        /**
+         * This method compiles the subtree of the resource space tree
+         * rooted at the given space into the flat router, depth-first.
+         *
+         * @param[in] space
+         *     This is the root of the subtree to compile.
+         *
+         * @return
+         *     The index of the router node compiled from the given
+         *     space is returned.
+         */
+        size_t CompileRouterNode(const std::shared_ptr< ResourceSpace >& space) {
+            const auto nodeIndex = routerNodes.size();
+            routerNodes.emplace_back();
+            routerNodes[nodeIndex].space = space;
+            for (const auto& subspacesEntry: space->subspaces) {
+                const auto subspaceNodeIndex = CompileRouterNode(subspacesEntry.second);
+                routerNodes[nodeIndex].subspaces.emplace_back(
+                    subspacesEntry.first,
+                    subspaceNodeIndex
+                );
+            }
+            return nodeIndex;
+        }
+
+        /**
+         * This method recompiles the resource space tree into the flat
+         * router used to match request paths.  It must be called, with
+         * the server's mutex held, whenever a resource is registered
+         * or unregistered.
+         */
+        void RebuildRouter() {
+            routerNodes.clear();
+            if (resources != nullptr) {
+                (void)CompileRouterNode(resources);
+            }
+            // Registering or unregistering a resource may change which
+            // handler a cached target maps to, so the response cache
+            // can no longer be trusted.
+            responseCache.clear();
+            responseCacheLruQueue.clear();
+            responseCacheTotal = 0;
+        }
+
+        /**
+         * This method matches the given request path against the compiled
+         * router, in one pass, returning the resource space of the deepest
+         * node reached.
+         *
+         * @param[in] path
+         *     This is the path of the request target to match.
+         *
+         * @param[out] segmentsMatched
+         *     This is where to store the number of leading path segments
+         *     consumed by the match (including any empty leading segment);
+         *     the remaining segments identify the resource within
+         *     the matched space.
+         *
+         * @return
+         *     The resource space of the deepest node reached is returned.
+         *
+         * @retval nullptr
+         *     This is returned if no resources are registered at all.
+         */
+        std::shared_ptr< ResourceSpace > RouteResource(
+            const std::vector< std::string >& path,
+            size_t& segmentsMatched
+        ) {
+            segmentsMatched = 0;
+            if (
+                !path.empty()
+                && path.front().empty()
+            ) {
+                segmentsMatched = 1;
+            }
+            if (routerNodes.empty()) {
+                return nullptr;
+            }
+            size_t nodeIndex = 0;
+            while (segmentsMatched < path.size()) {
+                const auto& subspaces = routerNodes[nodeIndex].subspaces;
+                const auto& segment = path[segmentsMatched];
+                const auto subspacesEntry = std::lower_bound(
+                    subspaces.begin(),
+                    subspaces.end(),
+                    segment,
+                    [](
+                        const std::pair< std::string, size_t >& subspace,
+                        const std::string& segment
+                    ){
+                        return subspace.first < segment;
+                    }
+                );
+                if (
+                    (subspacesEntry == subspaces.end())
+                    || (subspacesEntry->first != segment)
+                ) {
+                    break;
+                }
+                nodeIndex = subspacesEntry->second;
+                ++segmentsMatched;
+            }
+            return routerNodes[nodeIndex].space;
+        }
+
+        /**
+         * This method cancels any timeouts scheduled for the given
+         * connection.  This is done when a streamed handler takes over
+         * the connection, since the server isn't processing anything
+         * else received on the connection until the handler is done.
+         *
+         * @param[in] connectionState
+         *     This is the state of the connection whose timeouts
+         *     should be canceled.
+         */
+        void SuspendConnectionTimeouts(
+            std::shared_ptr< ConnectionState > connectionState
+        ) {
+            connectionState->idleTimeoutDue = 0.0;
+            connectionState->inactivityTimeoutDue = 0.0;
+            connectionState->requestTimeoutDue = 0.0;
+        }
+
+        /**
+         * This method constructs the response writer through which a
+         * streamed handler sends its response back to the client, and
+         * marks the connection as having a streamed response in progress,
+         * which holds off parsing of any subsequent requests until
+         * the response is finished.
+         *
+         * @param[in] connectionState
+         *     This is the state of the connection on which to send
+         *     the response.
+         *
+         * @param[in] request
+         *     This is the request for which the response will be sent.
+         *
+         * @return
+         *     The response writer to give to the streamed handler
+         *     is returned.
+         */
+        std::shared_ptr< ServerResponseWriter > MakeResponseWriter(
+            std::shared_ptr< ConnectionState > connectionState,
+            const Request& request
+        ) {
+            const auto writer = std::make_shared< ServerResponseWriter >();
+            std::weak_ptr< ConnectionState > connectionStateWeak(connectionState);
+            writer->connectionStateWeak = connectionStateWeak;
+            writer->closeAfterResponse = request.headers.HasHeaderToken("Connection", "close");
+            writer->sendQueueLowWatermark = sendQueueLowWatermark;
+            writer->finishedDelegate = [this, connectionStateWeak](bool closeRequested){
+                const auto connectionState = connectionStateWeak.lock();
+                if (connectionState == nullptr) {
+                    return;
+                }
+                connectionState->streamedResponseInProgress = false;
+                connectionState->abandonStreamedResponse = nullptr;
+
+                // If the response was finished before the entire body of
+                // the request was received, the rest of the incoming body
+                // can't be told apart from a next request, so the
+                // connection has to be closed.
+                const bool requestBodyIncomplete = (connectionState->requestReader != nullptr);
+                if (requestBodyIncomplete) {
+                    connectionState->requestReader = nullptr;
+                }
+                if (
+                    closeRequested
+                    || requestBodyIncomplete
+                ) {
+                    connectionState->acceptingRequests = false;
+                    connectionState->serverClosed = true;
+                    OnConnectionBroken(
+                        connectionState,
+                        "closed by server",
+                        ServerConnectionEndHandling::CloseGracefully
+                    );
+                } else {
+                    StartNextRequest(connectionState);
+                    if (!connectionState->reassemblyBuffer.IsEmpty()) {
+                        DataReceived(connectionState, std::vector< uint8_t >());
+                    }
+                }
+            };
+            connectionState->streamedResponseInProgress = true;
+            connectionState->abandonStreamedResponse = [writer]{
+                writer->NotifyAbandoned();
+            };
+            return writer;
+        }
+
+        /**
+         * This method dispatches the given request to the given streamed
+         * resource handler, giving it a response writer through which
+         * to stream a response back to the client.  The server holds off
+         * parsing any subsequent requests received on the connection
+         * until the streamed response is finished.
+         *
+         * @param[in] connectionState
+         *     This is the state of the connection on which the request
+         *     was made.
+         *
+         * @param[in] request
+         *     This is the request to apply to the resource.
+         *
+         * @param[in] streamedHandler
+         *     This is the handler responsible for streaming back
+         *     a response to the request.
+         *
+         * @param[in] originalTargetAsString
+         *     This is the original target URI of the request rendered
+         *     as a string.
+         */
+        void DispatchStreamedRequest(
+            std::shared_ptr< ConnectionState > connectionState,
+            std::shared_ptr< Request > request,
+            const Http::Server::StreamedResourceDelegate& streamedHandler,
+            const std::string& originalTargetAsString
+        ) {
+            SuspendConnectionTimeouts(connectionState);
+            const auto writer = MakeResponseWriter(connectionState, *request);
+            if (DiagnosticsWanted(1)) {
+                const auto method = request->method;
+                const auto peerId = connectionState->connection->GetPeerId();
+                PublishDiagnostics(
+                    1,
+                    [method, originalTargetAsString, peerId]{
+                        return StringExtensions::sprintf(
+                            "Request: %s '%s' from %s: streaming response",
+                            method.c_str(),
+                            originalTargetAsString.c_str(),
+                            peerId.c_str()
+                        );
+                    }
+                );
+            }
+            streamedHandler(*request, writer);
+        }
+
+        /**
+         * This method offers the request whose headers have just been
+         * received on the given connection to any registered streamed
+         * request handler.  If a handler claims the request, it's called
+         * immediately, and the body of the request is delivered to it
+         * through a request reader as the body arrives on the connection,
+         * rather than being buffered.
+         *
+         * @param[in] connectionState
+         *     This is the state of the connection on which the request
+         *     is arriving.
+         *
+         * @return
+         *     An indication of whether or not the request was claimed
+         *     by a streamed request handler is returned.
+         */
+        bool TryClaimRequestBody(
+            std::shared_ptr< ConnectionState > connectionState
+        ) {
+            const auto request = connectionState->nextRequest;
+            if (!request->valid) {
+                return false;
+            }
+
+            // A request body delivered through a transfer coding has no
+            // predetermined length, so it can't be streamed this way;
+            // leave it for the buffered parsing path to handle.
+            if (request->headers.HasHeader("Transfer-Encoding")) {
+                return false;
+            }
+
+            // Determine the length of the body up front; if the
+            // "Content-Length" header is unusable, the normal parsing
+            // path will reject the request.
+            intmax_t contentLengthAsInt = 0;
+            if (request->headers.HasHeader("Content-Length")) {
+                if (
+                    StringExtensions::ToInteger(
+                        request->headers.GetHeaderValue("Content-Length"),
+                        contentLengthAsInt
+                    ) != StringExtensions::ToIntegerResult::Success
+                ) {
+                    return false;
+                }
+                if (contentLengthAsInt < 0) {
+                    return false;
+                }
+            }
+            std::lock_guard< decltype(mutex) > lock(mutex);
+            const auto originalTargetAsString = request->rawTarget;
+            auto originalResourcePath = request->target.GetPath();
+            size_t segmentsMatched;
+            const auto resource = RouteResource(originalResourcePath, segmentsMatched);
+            if (
+                (resource == nullptr)
+                || (resource->streamedRequestHandler == nullptr)
+            ) {
+                return false;
+            }
+            auto& client = FetchConnectionDossier(connectionState);
+            if (
+                (tooManyRequestsThreshold != 0.0)
+                && !IsAcceptlisted(connectionState)
+                && !CheckRequestFrequency(client)
+            ) {
+                const auto staticResponse = FindStaticResponse(429, "Too Many Requests", true);
+                connectionState->shard->metrics.requestsRejectedTooMany.fetch_add(
+                    1,
+                    std::memory_order_relaxed
+                );
+                ReportRequest(
+                    *request,
+                    staticResponse->response,
+                    originalTargetAsString,
+                    connectionState->connection->GetPeerId()
+                );
+                BanHammer(connectionState->clientAddress, "Bad HTTP: 429 Too Many Requests");
+                IssueStaticResponse(connectionState, *staticResponse, false);
+                return true;
+            }
+            originalResourcePath.erase(
+                originalResourcePath.begin(),
+                originalResourcePath.begin() + segmentsMatched
+            );
+            request->target.SetPath(originalResourcePath);
+            SuspendConnectionTimeouts(connectionState);
+            const auto reader = std::make_shared< ServerRequestReader >();
+            reader->connectionStateWeak = connectionState;
+            reader->bytesRemaining = (size_t)contentLengthAsInt;
+            connectionState->requestReader = reader;
+            connectionState->nextRequest = FetchSpareRequest(connectionState);
+            const auto writer = MakeResponseWriter(connectionState, *request);
+            if (DiagnosticsWanted(1)) {
+                const auto method = request->method;
+                const auto peerId = connectionState->connection->GetPeerId();
+                PublishDiagnostics(
+                    1,
+                    [method, originalTargetAsString, peerId]{
+                        return StringExtensions::sprintf(
+                            "Request: %s '%s' from %s: streaming request",
+                            method.c_str(),
+                            originalTargetAsString.c_str(),
+                            peerId.c_str()
+                        );
+                    }
+                );
             }
+            connectionState->shard->metrics.requestsReceived.fetch_add(
+                1,
+                std::memory_order_relaxed
+            );
+            resource->streamedRequestHandler(*request, reader, writer);
+            reader->DeliverAvailableBody();
+            return true;
         }
 
         /**
@@ -1274,16 +3852,14 @@ namespace Http {
             }
             const auto now = timeKeeper->GetCurrentTime();
             connectionState->requestInProgress = true;
-            if (connectionState->idleTimeoutToken != 0) {
-                scheduler->Cancel(connectionState->idleTimeoutToken);
-                connectionState->idleTimeoutToken = 0;
-            }
+            connectionState->idleTimeoutDue = 0.0;
             connectionState->timeLastDataReceived = now;
-            if (connectionState->inactivityTimeoutToken != 0) {
-                scheduler->Cancel(connectionState->inactivityTimeoutToken);
-                connectionState->inactivityTimeoutToken = 0;
-            }
-            connectionState->reassemblyBuffer += std::string(data.begin(), data.end());
+            connectionState->inactivityTimeoutDue = 0.0;
+            connectionState->shard->metrics.bytesReceived.fetch_add(
+                data.size(),
+                std::memory_order_relaxed
+            );
+            connectionState->reassemblyBuffer.Append(data);
             if (connectionState->requestExtract.size() < badRequestReportBytes) {
                 connectionState->requestExtract.insert(
                     connectionState->requestExtract.end(),
@@ -1294,64 +3870,134 @@ namespace Http {
                     )
                 );
             }
-            while (connectionState->acceptingRequests) {
+            if (connectionState->requestReader != nullptr) {
+                // The body of a claimed request is arriving; deliver it
+                // to the streamed request handler instead of parsing it.
+                const auto reader = connectionState->requestReader;
+                reader->DeliverAvailableBody();
+            }
+            while (
+                connectionState->acceptingRequests
+                && !connectionState->streamedResponseInProgress
+                && (connectionState->requestReader == nullptr)
+            ) {
+                auto& metrics = connectionState->shard->metrics;
+                const auto parseStart = timeKeeper->GetCurrentTime();
                 const auto request = TryRequestAssembly(connectionState);
+                metrics.parseTimeMicroseconds.fetch_add(
+                    (size_t)((timeKeeper->GetCurrentTime() - parseStart) * 1000000.0),
+                    std::memory_order_relaxed
+                );
                 if (request == nullptr) {
                     break;
                 }
-                const auto clientAddress = connectionState->connection->GetPeerAddress();
-                auto& client = clients[clientAddress];
+                metrics.requestsReceived.fetch_add(1, std::memory_order_relaxed);
+                // Assembling the request only requires the connection's
+                // shard mutex, but dispatching it touches cross-cutting
+                // state (client dossiers and registered resources), which
+                // is guarded by the server's mutex.
+                std::lock_guard< decltype(mutex) > dispatchLock(mutex);
+                auto& client = FetchConnectionDossier(connectionState);
                 Response response;
+                const StaticResponse* staticResponse = nullptr;
                 if (
                     (tooManyRequestsThreshold != 0.0)
-                    && (acceptlist.find(clientAddress) == acceptlist.end())
+                    && !IsAcceptlisted(connectionState)
                     && !CheckRequestFrequency(client)
                 ) {
-                    response.statusCode = 429;
-                    response.reasonPhrase = "Too Many Requests";
-                    response.headers.SetHeader("Connection", "close");
+                    metrics.requestsRejectedTooMany.fetch_add(1, std::memory_order_relaxed);
+                    staticResponse = FindStaticResponse(429, "Too Many Requests", true);
                     ReportRequest(
                         *request,
-                        response,
-                        request->target.GenerateString(),
+                        staticResponse->response,
+                        request->rawTarget,
                         connectionState->connection->GetPeerId()
                     );
-                    BanHammer(clientAddress, "Bad HTTP: 429 Too Many Requests");
+                    BanHammer(connectionState->clientAddress, "Bad HTTP: 429 Too Many Requests");
                 } else if (
                     (request->state == Request::State::Complete)
                     && request->valid
                 ) {
-                    const auto originalTargetAsString = request->target.GenerateString();
-                    const auto originalResourcePath = request->target.GetPath();
-                    std::deque< std::string > resourcePath(
-                        originalResourcePath.begin(),
-                        originalResourcePath.end()
-                    );
+                    const auto originalTargetAsString = request->rawTarget;
+                    auto originalResourcePath = request->target.GetPath();
+                    size_t segmentsMatched;
+                    const auto resource = RouteResource(originalResourcePath, segmentsMatched);
                     if (
-                        !resourcePath.empty()
-                        && (resourcePath.front() == "")
-                    ) {
-                        (void)resourcePath.pop_front();
-                    }
-                    std::shared_ptr< ResourceSpace > resource = resources;
-                    while (
                         (resource != nullptr)
-                        && !resourcePath.empty()
+                        && (resource->streamedHandler != nullptr)
                     ) {
-                        const auto subspaceEntry = resource->subspaces.find(resourcePath.front());
-                        if (subspaceEntry == resource->subspaces.end()) {
-                            break;
+                        originalResourcePath.erase(
+                            originalResourcePath.begin(),
+                            originalResourcePath.begin() + segmentsMatched
+                        );
+                        request->target.SetPath(originalResourcePath);
+                        DispatchStreamedRequest(
+                            connectionState,
+                            request,
+                            resource->streamedHandler,
+                            originalTargetAsString
+                        );
+                        if (connectionState->reassemblyBuffer.IsEmpty()) {
+                            connectionState->requestExtract.clear();
                         } else {
-                            resource = subspaceEntry->second;
-                            resourcePath.pop_front();
+                            connectionState->requestExtract.assign(
+                                connectionState->reassemblyBuffer.Data(),
+                                connectionState->reassemblyBuffer.Data() + std::min(
+                                    connectionState->reassemblyBuffer.Length(),
+                                    badRequestReportBytes
+                                )
+                            );
                         }
-                    }
-                    if (
+
+                        // The response writer takes over issuing
+                        // the response from here.
+                        continue;
+                    } else if (
                         (resource != nullptr)
                         && (resource->handler != nullptr)
                     ) {
-                        request->target.SetPath({ resourcePath.begin(), resourcePath.end() });
-                        response = resource->handler(*request, connectionState->connection, connectionState->reassemblyBuffer);
+                        const auto responseCacheEntry = FetchCachedResponse(
+                            *request,
+                            originalTargetAsString,
+                            metrics
+                        );
+                        if (responseCacheEntry != nullptr) {
+                            SendCachedResponse(connectionState, *responseCacheEntry);
+                            ReportRequest(
+                                *request,
+                                responseCacheEntry->response,
+                                originalTargetAsString,
+                                connectionState->connection->GetPeerId()
+                            );
+                            if (connectionState->reassemblyBuffer.IsEmpty()) {
+                                connectionState->requestExtract.clear();
+                            } else {
+                                connectionState->requestExtract.assign(
+                                    connectionState->reassemblyBuffer.Data(),
+                                    connectionState->reassemblyBuffer.Data() + std::min(
+                                        connectionState->reassemblyBuffer.Length(),
+                                        badRequestReportBytes
+                                    )
+                                );
+                            }
+                            RecycleRequest(connectionState, request);
+                            continue;
+                        }
+                        originalResourcePath.erase(
+                            originalResourcePath.begin(),
+                            originalResourcePath.begin() + segmentsMatched
+                        );
+                        request->target.SetPath(originalResourcePath);
+                        const auto handlerStart = timeKeeper->GetCurrentTime();
+                        response = resource->handler(
+                            *request,
+                            connectionState->connection,
+                            connectionState->reassemblyBuffer.ToString()
+                        );
+                        metrics.handlerTimeMicroseconds.fetch_add(
+                            (size_t)((timeKeeper->GetCurrentTime() - handlerStart) * 1000000.0),
+                            std::memory_order_relaxed
+                        );
                         std::string codingsApplied;
                         for (const auto& coding: response.headers.GetHeaderTokens("Content-Encoding")) {
                             static const std::map< std::string, DeflateMode > deflateModesSupported{
@@ -1371,7 +4017,7 @@ namespace Http {
                                 response.body = Deflate(response.body, codingEntry->second);
                                 response.headers.SetHeader(
                                     "Content-Length",
-                                    StringExtensions::sprintf("%zu", response.body.size())
+                                    NumberToString(response.body.size())
                                 );
                             }
                         }
@@ -1380,13 +4026,22 @@ namespace Http {
                         } else {
                             response.headers.SetHeader("Content-Encoding", codingsApplied);
                         }
+                        StoreResponseInCache(
+                            *request,
+                            originalTargetAsString,
+                            response
+                        );
                     } else {
-                        response.statusCode = 404;
-                        response.reasonPhrase = "Not Found";
-                        response.headers.SetHeader("Content-Type", "text/plain");
-                        response.body = "FeelsBadMan\r\n";
+                        staticResponse = FindStaticResponse(
+                            404,
+                            "Not Found",
+                            request->headers.HasHeaderToken("Connection", "close")
+                        );
                     }
-                    if (request->headers.HasHeaderToken("Connection", "close")) {
+                    if (
+                        (staticResponse == nullptr)
+                        && request->headers.HasHeaderToken("Connection", "close")
+                    ) {
                         auto responseConnectionTokens = response.headers.GetHeaderTokens("Connection");
                         bool closeResponded = false;
                         for (const auto& connectionToken: responseConnectionTokens) {
@@ -1402,103 +4057,106 @@ namespace Http {
                     }
                     ReportRequest(
                         *request,
-                        response,
+                        (staticResponse == nullptr) ? response : staticResponse->response,
                         originalTargetAsString,
                         connectionState->connection->GetPeerId()
                     );
                 } else {
-                    response.statusCode = request->responseStatusCode;
-                    response.reasonPhrase = request->responseReasonPhrase;
-                    response.headers.SetHeader("Content-Type", "text/plain");
-                    response.body = "FeelsBadMan\r\n";
-                    if (request->state == Request::State::Error) {
-                        response.headers.SetHeader("Connection", "close");
-                    }
-                    std::ostringstream requestExtractStringBuilder;
-                    requestExtractStringBuilder << std::hex << std::setfill('0');
-                    for (auto ch: connectionState->requestExtract) {
-                        if ((ch <= 0x20) || (ch > 0x7E)) {
-                            requestExtractStringBuilder << "\\x" << std::setw(2) << (int)ch;
-                        } else {
-                            requestExtractStringBuilder << (char)ch;
+                    staticResponse = FindStaticResponse(
+                        request->responseStatusCode,
+                        request->responseReasonPhrase,
+                        (request->state == Request::State::Error)
+                    );
+                    if (staticResponse == nullptr) {
+                        response.statusCode = request->responseStatusCode;
+                        response.reasonPhrase = request->responseReasonPhrase;
+                        response.headers.SetHeader("Content-Type", "text/plain");
+                        response.body = "FeelsBadMan\r\n";
+                        if (request->state == Request::State::Error) {
+                            response.headers.SetHeader("Connection", "close");
                         }
                     }
-                    diagnosticsSender.SendDiagnosticInformationFormatted(
-                        3, "Request: Bad request from %s: %s",
-                        connectionState->connection->GetPeerId().c_str(),
-                        requestExtractStringBuilder.str().c_str()
-                    );
+                    if (DiagnosticsWanted(3)) {
+                        const auto peerId = connectionState->connection->GetPeerId();
+                        const auto requestExtract = connectionState->requestExtract;
+                        PublishDiagnostics(
+                            3,
+                            [peerId, requestExtract]{
+                                std::ostringstream requestExtractStringBuilder;
+                                requestExtractStringBuilder << std::hex << std::setfill('0');
+                                for (auto ch: requestExtract) {
+                                    if ((ch <= 0x20) || (ch > 0x7E)) {
+                                        requestExtractStringBuilder << "\\x" << std::setw(2) << (int)ch;
+                                    } else {
+                                        requestExtractStringBuilder << (char)ch;
+                                    }
+                                }
+                                return StringExtensions::sprintf(
+                                    "Request: Bad request from %s: %s",
+                                    peerId.c_str(),
+                                    requestExtractStringBuilder.str().c_str()
+                                );
+                            }
+                        );
+                    }
                 }
-                if (connectionState->reassemblyBuffer.empty()) {
+                if (connectionState->reassemblyBuffer.IsEmpty()) {
                     connectionState->requestExtract.clear();
                 } else {
                     connectionState->requestExtract.assign(
-                        connectionState->reassemblyBuffer.begin(),
-                        connectionState->reassemblyBuffer.begin() + std::min(
-                            connectionState->reassemblyBuffer.size(),
+                        connectionState->reassemblyBuffer.Data(),
+                        connectionState->reassemblyBuffer.Data() + std::min(
+                            connectionState->reassemblyBuffer.Length(),
                             badRequestReportBytes
                         )
                     );
                 }
-                IssueResponse(connectionState, response, false);
-                if (response.statusCode == 101) {
+                if (staticResponse == nullptr) {
+                    IssueResponse(connectionState, response, false);
+                } else {
+                    IssueStaticResponse(connectionState, *staticResponse, false);
+                }
+                if (
+                    (staticResponse == nullptr)
+                    && (response.statusCode == 101)
+                ) {
                     connectionState->acceptingRequests = false;
                     connectionState->connection = nullptr;
                     (void)connectionsToDrop.insert(connectionState);
                     reaperWakeCondition.notify_all();
-                    (void)activeConnections.erase(connectionState);
+                    (void)connectionState->shard->activeConnections.erase(connectionState);
                 }
+                RecycleRequest(connectionState, request);
             }
             if (
                 connectionState->requestInProgress
-                && (connectionState->inactivityTimeoutToken == 0)
+                && !connectionState->streamedResponseInProgress
+                && (connectionState->inactivityTimeoutDue == 0.0)
             ) {
-                std::weak_ptr< ConnectionState > connectionStateWeak(connectionState);
-                const auto timeoutCallback = [
-                    this,
-                    connectionStateWeak
-                ]{
-                    auto connectionState = connectionStateWeak.lock();
-                    if (connectionState != nullptr) {
-                        IssueTimeoutResponse(connectionState);
-                    }
-                };
-                connectionState->requestTimeoutToken = scheduler->Schedule(
-                    timeoutCallback,
-                    now + requestTimeout
-                );
-                connectionState->inactivityTimeoutToken = scheduler->Schedule(
-                    timeoutCallback,
-                    now + inactivityTimeout
-                );
+                if (connectionState->requestTimeoutDue == 0.0) {
+                    connectionState->requestTimeoutDue = now + requestTimeout;
+                }
+                connectionState->inactivityTimeoutDue = now + inactivityTimeout;
+                ArmConnectionTimeouts(connectionState);
             }
         }
 
         /**
-         * Check to see if the connection from the given client should be
-         * denied due to exceeding the connection rate limit.
-         *
-         * @param[in] client
-         *     This is the client whose connection is being evaluated.
+         * Check to see if an incoming connection should be denied due
+         * to exceeding the server-wide connection rate limit.
          *
          * @return
-         *     An indication of whether or not the client's connection
+         *     An indication of whether or not the connection
          *     should be accepted is returned.
          */
-        bool CheckConnectFrequency(const ClientDossier& client) {
+        bool CheckConnectFrequency() {
             const auto now = timeKeeper->GetCurrentTime();
-            while (
-                !lastConnectTimes.empty()
-                && (lastConnectTimes.front() < now - tooManyConnectsMeasurementPeriod)
-            ) {
-                lastConnectTimes.pop_front();
-            }
-            const auto numConnectsAcrossMeasurementPeriod = lastConnectTimes.size();
-            const auto averageConnectsPerSecond = (
-                (double)numConnectsAcrossMeasurementPeriod
-                / tooManyConnectsMeasurementPeriod
+            connectBucket.Refill(
+                now,
+                tooManyConnectsThreshold,
+                tooManyConnectsThreshold * tooManyConnectsMeasurementPeriod
             );
-            if (averageConnectsPerSecond >= tooManyConnectsThreshold) {
+            if (connectBucket.tokens < 1.0) {
                 if (!connectRateLimited) {
                     connectRateLimited = true;
                     diagnosticsSender.SendDiagnosticInformationString(
@@ -1509,7 +4167,7 @@ namespace Http {
                 return false;
             }
             connectRateLimited = false;
-            lastConnectTimes.push_back(now);
+            connectBucket.tokens -= 1.0;
             return true;
         }
 
@@ -1519,7 +4177,7 @@ namespace Http {
          *
          * @param[in,out] client
          *     This is the client whose request is being evaluated.
-         *     Its history of request times may be updated.
+         *     Its request rate-limit token bucket is updated.
          *
          * @return
          *     An indication of whether or not the client's
@@ -1527,16 +4185,21 @@ namespace Http {
          */
         bool CheckRequestFrequency(ClientDossier& client) {
             const auto now = timeKeeper->GetCurrentTime();
-            client.lastRequestTimes.push_back(now);
-            while (client.lastRequestTimes.front() < now - tooManyRequestsMeasurementPeriod) {
-                client.lastRequestTimes.pop_front();
-            }
-            const auto numClientRequestsAcrossMeasurementPeriod = client.lastRequestTimes.size();
-            const auto averageClientRequestsPerSecond = (
-                (double)numClientRequestsAcrossMeasurementPeriod
-                / tooManyRequestsMeasurementPeriod
+            client.requestBucket.Refill(
+                now,
+                tooManyRequestsThreshold,
+                tooManyRequestsThreshold * tooManyRequestsMeasurementPeriod
+            );
+
+            // The request spends a token whether or not it's accepted,
+            // just as every request used to be recorded in the client's
+            // history of request times.
+            const auto accepted = (client.requestBucket.tokens > 1.0);
+            client.requestBucket.tokens = std::max(
+                0.0,
+                client.requestBucket.tokens - 1.0
             );
-            return (averageClientRequestsPerSecond < tooManyRequestsThreshold);
+            return accepted;
         }
 
         /**
@@ -1550,38 +4213,58 @@ namespace Http {
          *     A delegate to be called when the connection is ready to be used
          *     is returned.
          */
+        /**
+         * This method selects the shard to which to assign a new connection
+         * from the client at the given address.  Connections from the same
+         * client always land in the same shard.
+         *
+         * @param[in] clientAddress
+         *     This is the address of the client making the connection.
+         *
+         * @return
+         *     The shard to which to assign the connection is returned.
+         */
+        std::shared_ptr< ConnectionShard > PickShard(const std::string& clientAddress) {
+            return shards[std::hash< std::string >{}(clientAddress) % shards.size()];
+        }
+
         ServerTransport::ConnectionReadyDelegate NewConnection(std::shared_ptr< Connection > connection) {
-            std::lock_guard< decltype(mutex) > lock(mutex);
             const auto clientAddress = connection->GetPeerAddress();
-            auto& client = clients[clientAddress];
-            if (client.banned) {
-                const auto now = timeKeeper->GetCurrentTime();
-                if (now < client.banStart + client.banPeriod) {
-                    diagnosticsSender.SendDiagnosticInformationFormatted(
-                        2, "New connection from %s -- banned",
-                        connection->GetPeerId().c_str()
-                    );
+            {
+                std::lock_guard< decltype(mutex) > lock(mutex);
+                auto& client = FetchClientDossier(clientAddress);
+                if (client.banned) {
+                    const auto now = timeKeeper->GetCurrentTime();
+                    if (now < client.banStart + client.banPeriod) {
+                        diagnosticsSender.SendDiagnosticInformationFormatted(
+                            2, "New connection from %s -- banned",
+                            connection->GetPeerId().c_str()
+                        );
+                        connection->Break(false);
+                        return nullptr;
+                    } else if (now >= client.banStart + client.banPeriod + probationPeriod) {
+                        client.banned = false;
+                    }
+                }
+                if (
+                    (acceptlist.find(clientAddress) == acceptlist.end())
+                    && !CheckConnectFrequency()
+                ) {
                     connection->Break(false);
                     return nullptr;
-                } else if (now >= client.banStart + client.banPeriod + probationPeriod) {
-                    client.banned = false;
                 }
             }
-            if (
-                (acceptlist.find(clientAddress) == acceptlist.end())
-                && !CheckConnectFrequency(client)
-            ) {
-                connection->Break(false);
-                return nullptr;
-            }
             diagnosticsSender.SendDiagnosticInformationFormatted(
                 2, "New connection from %s",
                 connection->GetPeerId().c_str()
             );
             const auto connectionState = std::make_shared< ConnectionState >();
+            connectionState->clientAddress = clientAddress;
+            connectionState->shard = PickShard(clientAddress);
+            std::lock_guard< decltype(connectionState->shard->mutex) > shardLock(connectionState->shard->mutex);
             StartNextRequest(connectionState);
             connectionState->connection = connection;
-            (void)activeConnections.insert(connectionState);
+            (void)connectionState->shard->activeConnections.insert(connectionState);
             std::weak_ptr< ConnectionState > connectionStateWeak(connectionState);
             connection->SetDataReceivedDelegate(
                 [this, connectionStateWeak](const std::vector< uint8_t >& data){
@@ -1589,7 +4272,7 @@ namespace Http {
                     if (connectionState == nullptr) {
                         return;
                     }
-                    std::lock_guard< decltype(mutex) > lock(mutex);
+                    std::lock_guard< decltype(connectionState->shard->mutex) > lock(connectionState->shard->mutex);
                     DataReceived(connectionState, data);
                 }
             );
@@ -1599,7 +4282,7 @@ namespace Http {
                     if (connectionState == nullptr) {
                         return;
                     }
-                    std::lock_guard< decltype(mutex) > lock(mutex);
+                    std::lock_guard< decltype(connectionState->shard->mutex) > lock(connectionState->shard->mutex);
                     if (connectionState->serverClosed) {
                         if (!connectionState->clientClosed) {
                             connectionState->clientClosed = true;
@@ -1647,6 +4330,12 @@ namespace Http {
         impl_->configuration["ProbationPeriod"] = FormatDoubleAsDistinctlyNotInteger(impl_->probationPeriod);
         impl_->configuration["TooManyRequestsThreshold"] = FormatDoubleAsDistinctlyNotInteger(impl_->tooManyRequestsThreshold);
         impl_->configuration["TooManyRequestsMeasurementPeriod"] = FormatDoubleAsDistinctlyNotInteger(impl_->tooManyRequestsMeasurementPeriod);
+        impl_->configuration["ConnectionShards"] = StringExtensions::sprintf("%zu", impl_->connectionShards);
+        impl_->configuration["MaxClientDossiers"] = StringExtensions::sprintf("%zu", impl_->maxClientDossiers);
+        impl_->configuration["ResponseCacheSize"] = StringExtensions::sprintf("%zu", impl_->responseCacheSize);
+        impl_->configuration["SendQueueLowWatermark"] = StringExtensions::sprintf("%zu", impl_->sendQueueLowWatermark);
+        impl_->configuration["AsyncDiagnostics"] = StringExtensions::sprintf("%zu", impl_->asyncDiagnostics);
+        impl_->BuildStaticResponses();
         impl_->reaper = std::thread(&Impl::Reaper, impl_.get());
     }
 
@@ -1654,40 +4343,84 @@ namespace Http {
         if (impl_->mobilized) {
             return false;
         }
-        impl_->transport = deps.transport;
-        if (
-            impl_->transport->BindNetwork(
-                impl_->port,
-                [this](std::shared_ptr< Connection > connection){
-                    return impl_->NewConnection(connection);
-                }
-            )
-        ) {
-            impl_->port = impl_->transport->GetBoundPort();
-            impl_->diagnosticsSender.SendDiagnosticInformationFormatted(
-                3, "Now listening on port %" PRIu16,
-                impl_->port
-            );
-        } else {
-            impl_->transport = nullptr;
+        std::vector< std::shared_ptr< ServerTransport > > transports;
+        if (deps.transport != nullptr) {
+            transports.push_back(deps.transport);
+        }
+        transports.insert(
+            transports.end(),
+            deps.transports.begin(),
+            deps.transports.end()
+        );
+        if (transports.empty()) {
             return false;
         }
-        impl_->configuration["Port"] = StringExtensions::sprintf("%" PRIu16, impl_->port);
+
+        // Everything a new connection touches has to be in place before
+        // the first transport is bound, because the connection delegate
+        // is live from that moment on.
         impl_->timeKeeper = deps.timeKeeper;
         impl_->scheduler.reset(new Timekeeping::Scheduler);
         impl_->scheduler->SetClock(
             std::make_shared< ClockWrapper >(impl_->timeKeeper)
         );
+        impl_->timeoutWheel.currentTick = (size_t)(
+            impl_->timeKeeper->GetCurrentTime() / TIMEOUT_WHEEL_SLOT_WIDTH
+        );
+        impl_->ScheduleTimeoutWheelTick();
+        if (impl_->shards.empty()) {
+            impl_->shards.resize(std::max< size_t >(impl_->connectionShards, 1));
+            for (auto& shard: impl_->shards) {
+                shard = std::make_shared< ConnectionShard >();
+            }
+        }
+        auto portToBind = impl_->port;
+        for (const auto& transport: transports) {
+            if (
+                transport->BindNetwork(
+                    portToBind,
+                    [this](std::shared_ptr< Connection > connection){
+                        return impl_->NewConnection(connection);
+                    }
+                )
+            ) {
+                // Any subsequent acceptors bind whatever port the first
+                // acceptor actually bound, so that a port of zero still
+                // means one server on one system-chosen port.
+                portToBind = transport->GetBoundPort();
+                impl_->transports.push_back(transport);
+            } else {
+                for (const auto& boundTransport: impl_->transports) {
+                    boundTransport->ReleaseNetwork();
+                }
+                impl_->transports.clear();
+                impl_->scheduler = nullptr;
+                impl_->timeKeeper = nullptr;
+                return false;
+            }
+        }
+        impl_->port = impl_->transports.front()->GetBoundPort();
+        impl_->diagnosticsSender.SendDiagnosticInformationFormatted(
+            3, "Now listening on port %" PRIu16,
+            impl_->port
+        );
+        impl_->configuration["Port"] = StringExtensions::sprintf("%" PRIu16, impl_->port);
         impl_->mobilized = true;
         return true;
     }
 
     void Server::Demobilize() {
         impl_->scheduler = nullptr;
-        if (impl_->transport != nullptr) {
-            impl_->transport->ReleaseNetwork();
-            impl_->transport = nullptr;
+        {
+            std::lock_guard< std::mutex > lock(impl_->timeoutWheel.mutex);
+            for (auto& slot: impl_->timeoutWheel.slots) {
+                slot.clear();
+            }
+        }
+        for (const auto& transport: impl_->transports) {
+            transport->ReleaseNetwork();
         }
+        impl_->transports.clear();
         impl_->timeKeeper = nullptr;
         impl_->mobilized = false;
     }
@@ -1718,7 +4451,36 @@ namespace Http {
         SystemAbstractions::DiagnosticsSender::DiagnosticMessageDelegate delegate,
         size_t minLevel
     ) {
-        return impl_->diagnosticsSender.SubscribeToDiagnostics(delegate, minLevel);
+        const auto unsubscribe = impl_->diagnosticsSender.SubscribeToDiagnostics(delegate, minLevel);
+        {
+            std::lock_guard< decltype(impl_->mutex) > lock(impl_->mutex);
+            (void)impl_->diagnosticSubscriberLevels.insert(minLevel);
+            impl_->minSubscribedDiagnosticLevel.store(
+                *impl_->diagnosticSubscriberLevels.begin(),
+                std::memory_order_relaxed
+            );
+        }
+        std::weak_ptr< Impl > implWeak(impl_);
+        return [implWeak, unsubscribe, minLevel]{
+            unsubscribe();
+            const auto impl = implWeak.lock();
+            if (impl == nullptr) {
+                return;
+            }
+            std::lock_guard< decltype(impl->mutex) > lock(impl->mutex);
+            const auto levelEntry = impl->diagnosticSubscriberLevels.find(minLevel);
+            if (levelEntry != impl->diagnosticSubscriberLevels.end()) {
+                (void)impl->diagnosticSubscriberLevels.erase(levelEntry);
+            }
+            impl->minSubscribedDiagnosticLevel.store(
+                (
+                    impl->diagnosticSubscriberLevels.empty()
+                    ? NO_DIAGNOSTIC_SUBSCRIBERS
+                    : *impl->diagnosticSubscriberLevels.begin()
+                ),
+                std::memory_order_relaxed
+            );
+        };
     }
 
     std::string Server::GetConfigurationItem(const std::string& key) {
@@ -1763,6 +4525,16 @@ namespace Http {
             impl_->ParseConfigurationItem(impl_->tooManyConnectsThreshold, "%lf", "%lf", "Too many connects threshold", value);
         } else if (key == "TooManyConnectsMeasurementPeriod") {
             impl_->ParseConfigurationItem(impl_->tooManyConnectsMeasurementPeriod, "%lf", "%lf", "Too many connects measurement period", value);
+        } else if (key == "ConnectionShards") {
+            impl_->ParseConfigurationItem(impl_->connectionShards, "%zu", "%zu", "Connection shards", value);
+        } else if (key == "MaxClientDossiers") {
+            impl_->ParseConfigurationItem(impl_->maxClientDossiers, "%zu", "%zu", "Maximum client dossiers", value);
+        } else if (key == "ResponseCacheSize") {
+            impl_->ParseConfigurationItem(impl_->responseCacheSize, "%zu", "%zu", "Response cache size", value);
+        } else if (key == "SendQueueLowWatermark") {
+            impl_->ParseConfigurationItem(impl_->sendQueueLowWatermark, "%zu", "%zu", "Send queue low watermark", value);
+        } else if (key == "AsyncDiagnostics") {
+            impl_->ParseConfigurationItem(impl_->asyncDiagnostics, "%zu", "%zu", "Asynchronous diagnostics", value);
         }
     }
 
@@ -1770,6 +4542,7 @@ namespace Http {
         const std::vector< std::string >& resourceSubspacePath,
         ResourceDelegate resourceDelegate
     ) -> UnregistrationDelegate {
+        std::lock_guard< decltype(impl_->mutex) > lock(impl_->mutex);
         std::shared_ptr< ResourceSpace > space = impl_->resources;
         if (space == nullptr) {
             space = impl_->resources = std::make_shared< ResourceSpace >();
@@ -1786,15 +4559,149 @@ namespace Http {
             }
             space = subspace;
         }
-        if (space->handler == nullptr) {
+        if (
+            (space->handler == nullptr)
+            && (space->streamedHandler == nullptr)
+            && (space->streamedRequestHandler == nullptr)
+        ) {
             space->handler = resourceDelegate;
+            impl_->RebuildRouter();
             return [this, space]{
+                std::lock_guard< decltype(impl_->mutex) > lock(impl_->mutex);
                 auto currentSpace = space;
                 currentSpace->handler = nullptr;
                 for (;;) {
                     auto superspace = currentSpace->superspace.lock();
                     if (
                         (currentSpace->handler == nullptr)
+                        && (currentSpace->streamedHandler == nullptr)
+                        && (currentSpace->streamedRequestHandler == nullptr)
+                        && currentSpace->subspaces.empty()
+                    ) {
+                        if (superspace == nullptr) { // at root level
+                            impl_->resources = nullptr;
+                            break;
+                        } else {
+                            (void)superspace->subspaces.erase(currentSpace->name);
+                        }
+                    }
+                    if (
+                        (superspace != nullptr)
+                        && superspace->subspaces.empty()
+                    ) {
+                        currentSpace = superspace;
+                    } else {
+                        break;
+                    }
+                }
+                impl_->RebuildRouter();
+            };
+        } else {
+            return nullptr;
+        }
+    }
+
+    auto Server::RegisterStreamedResource(
+        const std::vector< std::string >& resourceSubspacePath,
+        StreamedResourceDelegate streamedResourceDelegate
+    ) -> UnregistrationDelegate {
+        std::lock_guard< decltype(impl_->mutex) > lock(impl_->mutex);
+        std::shared_ptr< ResourceSpace > space = impl_->resources;
+        if (space == nullptr) {
+            space = impl_->resources = std::make_shared< ResourceSpace >();
+        }
+        for (const auto& pathSegment: resourceSubspacePath) {
+            std::shared_ptr< ResourceSpace > subspace;
+            auto subspacesEntry = space->subspaces.find(pathSegment);
+            if (subspacesEntry == space->subspaces.end()) {
+                subspace = space->subspaces[pathSegment] = std::make_shared< ResourceSpace >();
+                subspace->name = pathSegment;
+                subspace->superspace = space;
+            } else {
+                subspace = subspacesEntry->second;
+            }
+            space = subspace;
+        }
+        if (
+            (space->handler == nullptr)
+            && (space->streamedHandler == nullptr)
+            && (space->streamedRequestHandler == nullptr)
+        ) {
+            space->streamedHandler = streamedResourceDelegate;
+            impl_->RebuildRouter();
+            return [this, space]{
+                std::lock_guard< decltype(impl_->mutex) > lock(impl_->mutex);
+                auto currentSpace = space;
+                currentSpace->streamedHandler = nullptr;
+                for (;;) {
+                    auto superspace = currentSpace->superspace.lock();
+                    if (
+                        (currentSpace->handler == nullptr)
+                        && (currentSpace->streamedHandler == nullptr)
+                        && (currentSpace->streamedRequestHandler == nullptr)
+                        && currentSpace->subspaces.empty()
+                    ) {
+                        if (superspace == nullptr) { // at root level
+                            impl_->resources = nullptr;
+                            break;
+                        } else {
+                            (void)superspace->subspaces.erase(currentSpace->name);
+                        }
+                    }
+                    if (
+                        (superspace != nullptr)
+                        && superspace->subspaces.empty()
+                    ) {
+                        currentSpace = superspace;
+                    } else {
+                        break;
+                    }
+                }
+                impl_->RebuildRouter();
+            };
+        } else {
+            return nullptr;
+        }
+    }
+
+    auto Server::RegisterStreamedRequestResource(
+        const std::vector< std::string >& resourceSubspacePath,
+        StreamedRequestResourceDelegate streamedRequestResourceDelegate
+    ) -> UnregistrationDelegate {
+        std::lock_guard< decltype(impl_->mutex) > lock(impl_->mutex);
+        std::shared_ptr< ResourceSpace > space = impl_->resources;
+        if (space == nullptr) {
+            space = impl_->resources = std::make_shared< ResourceSpace >();
+        }
+        for (const auto& pathSegment: resourceSubspacePath) {
+            std::shared_ptr< ResourceSpace > subspace;
+            auto subspacesEntry = space->subspaces.find(pathSegment);
+            if (subspacesEntry == space->subspaces.end()) {
+                subspace = space->subspaces[pathSegment] = std::make_shared< ResourceSpace >();
+                subspace->name = pathSegment;
+                subspace->superspace = space;
+            } else {
+                subspace = subspacesEntry->second;
+            }
+            space = subspace;
+        }
+        if (
+            (space->handler == nullptr)
+            && (space->streamedHandler == nullptr)
+            && (space->streamedRequestHandler == nullptr)
+        ) {
+            space->streamedRequestHandler = streamedRequestResourceDelegate;
+            impl_->RebuildRouter();
+            return [this, space]{
+                std::lock_guard< decltype(impl_->mutex) > lock(impl_->mutex);
+                auto currentSpace = space;
+                currentSpace->streamedRequestHandler = nullptr;
+                for (;;) {
+                    auto superspace = currentSpace->superspace.lock();
+                    if (
+                        (currentSpace->handler == nullptr)
+                        && (currentSpace->streamedHandler == nullptr)
+                        && (currentSpace->streamedRequestHandler == nullptr)
                         && currentSpace->subspaces.empty()
                     ) {
                         if (superspace == nullptr) { // at root level
@@ -1813,6 +4720,7 @@ namespace Http {
                         break;
                     }
                 }
+                impl_->RebuildRouter();
             };
         } else {
             return nullptr;
@@ -1840,6 +4748,38 @@ namespace Http {
         return impl_->timeKeeper;
     }
 
+    auto Server::GetMetricsSnapshot() -> MetricsSnapshot {
+        MetricsSnapshot snapshot;
+        snapshot.bansIssued = impl_->bansIssued.load(std::memory_order_relaxed);
+        size_t parseTimeMicroseconds = 0;
+        size_t handlerTimeMicroseconds = 0;
+        for (const auto& shard: impl_->shards) {
+            const auto& metrics = shard->metrics;
+            snapshot.requestsReceived += metrics.requestsReceived.load(std::memory_order_relaxed);
+            snapshot.responsesInformational += metrics.responsesInformational.load(std::memory_order_relaxed);
+            snapshot.responsesSuccess += metrics.responsesSuccess.load(std::memory_order_relaxed);
+            snapshot.responsesRedirection += metrics.responsesRedirection.load(std::memory_order_relaxed);
+            snapshot.responsesClientError += metrics.responsesClientError.load(std::memory_order_relaxed);
+            snapshot.responsesServerError += metrics.responsesServerError.load(std::memory_order_relaxed);
+            snapshot.requestsRejectedTooMany += metrics.requestsRejectedTooMany.load(std::memory_order_relaxed);
+            snapshot.responseCacheHits += metrics.responseCacheHits.load(std::memory_order_relaxed);
+            snapshot.responseCacheMisses += metrics.responseCacheMisses.load(std::memory_order_relaxed);
+            snapshot.bytesReceived += metrics.bytesReceived.load(std::memory_order_relaxed);
+            snapshot.bytesSent += metrics.bytesSent.load(std::memory_order_relaxed);
+            parseTimeMicroseconds += metrics.parseTimeMicroseconds.load(std::memory_order_relaxed);
+            handlerTimeMicroseconds += metrics.handlerTimeMicroseconds.load(std::memory_order_relaxed);
+
+            // Counting the connections assigned to the shard holds its
+            // mutex only momentarily; traffic on other shards is
+            // unaffected.
+            std::lock_guard< decltype(shard->mutex) > lock(shard->mutex);
+            snapshot.activeConnections += shard->activeConnections.size();
+        }
+        snapshot.parseTime = (double)parseTimeMicroseconds / 1000000.0;
+        snapshot.handlerTime = (double)handlerTimeMicroseconds / 1000000.0;
+        return snapshot;
+    }
+
     void Server::Ban(
         const std::string& peerAddress,
         const std::string& reason
@@ -1850,7 +4790,7 @@ namespace Http {
 
     void Server::Unban(const std::string& peerAddress) {
         std::lock_guard< decltype(impl_->mutex) > lock(impl_->mutex);
-        auto& client = impl_->clients[peerAddress];
+        auto& client = impl_->FetchClientDossier(peerAddress);
         client.banned = false;
     }
 
@@ -1873,11 +4813,13 @@ namespace Http {
     void Server::AcceptlistAdd(const std::string& peerAddress) {
         std::lock_guard< decltype(impl_->mutex) > lock(impl_->mutex);
         (void)impl_->acceptlist.insert(peerAddress);
+        ++impl_->acceptlistGeneration;
     }
 
     void Server::AcceptlistRemove(const std::string& peerAddress) {
         std::lock_guard< decltype(impl_->mutex) > lock(impl_->mutex);
         (void)impl_->acceptlist.erase(peerAddress);
+        ++impl_->acceptlistGeneration;
     }
 
     std::set< std::string > Server::GetAcceptlist() {
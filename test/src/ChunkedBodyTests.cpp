@@ -116,6 +116,13 @@ TEST_F(ChunkedBodyTests, DecodeSimpleNonEmptyBodyOnePiece) {
     ASSERT_EQ("Hello", (std::string)body);
 }
 
+TEST_F(ChunkedBodyTests, TakeBodyMovesDecodedBodyOut) {
+    ASSERT_EQ(15, body.Decode("5\r\nHello\r\n0\r\n\r\n"));
+    ASSERT_EQ(Http::ChunkedBody::State::Complete, body.GetState());
+    ASSERT_EQ("Hello", body.TakeBody());
+    ASSERT_EQ("", (std::string)body);
+}
+
 TEST_F(ChunkedBodyTests, DecodeSimpleNonEmptyBodyOneCharacterAtATime) {
     const std::string input = "5\r\nHello\r\n0\r\n\r\n";
     size_t accepted = 0;
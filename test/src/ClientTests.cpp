@@ -1025,6 +1025,284 @@ TEST_F(ClientTests, TwoRequestsSameServerReusesPersistentConnection) {
     EXPECT_EQ("Poggers", transaction->response.body);
 }
 
+TEST_F(ClientTests, ConcurrentRequestsBeyondMaxConnectionsPerServerNotPersisted) {
+    // Set up the client, allowing only one persistent connection
+    // per server.
+    const auto transport = std::make_shared< MockTransport >();
+    transport->connectionsAllowed = 2;
+    Http::Client::MobilizationDependencies deps;
+    deps.transport = transport;
+    deps.timeKeeper = std::make_shared< MockTimeKeeper >();
+    deps.maxConnectionsPerServer = 1;
+    client.Mobilize(deps);
+
+    // Have the client make two concurrent requests to the same server,
+    // both asking to persist their connections.  Since the pool only has
+    // room for one connection to the server, expect the second request to
+    // open its own connection and mark it to be closed after the response.
+    Http::Request outgoingRequest;
+    outgoingRequest.method = "GET";
+    outgoingRequest.target.ParseFromString("http://www.example.com:1234/foo");
+    auto transaction1 = client.Request(outgoingRequest, true);
+    outgoingRequest = Http::Request();
+    outgoingRequest.method = "GET";
+    outgoingRequest.target.ParseFromString("http://www.example.com:1234/bar");
+    auto transaction2 = client.Request(outgoingRequest, true);
+    ASSERT_TRUE(transport->AwaitConnections(2));
+    const auto& connection1 = transport->connections[0];
+    const auto& connection2 = transport->connections[1];
+    EXPECT_FALSE(connection1->requests[0].headers.HasHeaderToken("Connection", "Close"));
+    EXPECT_TRUE(connection2->requests[0].headers.HasHeaderToken("Connection", "Close"));
+
+    // Provide responses back to the client on both connections.
+    Http::Response response;
+    response.statusCode = 200;
+    response.reasonPhrase = "OK";
+    response.headers.SetHeader("Content-Type", "text/plain");
+    response.headers.SetHeader("Content-Length", "8");
+    response.body = "PogChamp";
+    const auto responseEncoding = response.Generate();
+    connection1->dataReceivedDelegate({responseEncoding.begin(), responseEncoding.end()});
+    connection2->dataReceivedDelegate({responseEncoding.begin(), responseEncoding.end()});
+    ASSERT_TRUE(transaction1->AwaitCompletion(std::chrono::milliseconds(100)));
+    ASSERT_TRUE(transaction2->AwaitCompletion(std::chrono::milliseconds(100)));
+
+    // Expect the pooled connection to remain open, and the overflow
+    // connection to be closed by the client.
+    EXPECT_FALSE(connection1->broken);
+    EXPECT_TRUE(connection2->broken);
+
+    // Have the client make a third request to the same server.
+    // Expect the pooled connection to be reused.
+    outgoingRequest = Http::Request();
+    outgoingRequest.method = "GET";
+    outgoingRequest.target.ParseFromString("http://www.example.com:1234/spam");
+    auto transaction3 = client.Request(outgoingRequest, true);
+    ASSERT_FALSE(transport->AwaitConnections(3));
+    ASSERT_TRUE(connection1->AwaitRequests(2));
+}
+
+TEST_F(ClientTests, SecondIdempotentRequestPipelinedOnBusyConnection) {
+    // Set up the client, allowing only one connection per server,
+    // but allowing up to two requests in flight on it at the same time.
+    const auto transport = std::make_shared< MockTransport >();
+    Http::Client::MobilizationDependencies deps;
+    deps.transport = transport;
+    deps.timeKeeper = std::make_shared< MockTimeKeeper >();
+    deps.maxConnectionsPerServer = 1;
+    deps.maxPipelineDepth = 2;
+    client.Mobilize(deps);
+
+    // Have the client make two concurrent GET requests to the same server,
+    // both asking to persist their connections.  Since GET is idempotent,
+    // expect the second request to be pipelined behind the first on the
+    // same connection, rather than opening another connection.
+    Http::Request outgoingRequest;
+    outgoingRequest.method = "GET";
+    outgoingRequest.target.ParseFromString("http://www.example.com:1234/foo");
+    auto transaction1 = client.Request(outgoingRequest, true);
+    outgoingRequest = Http::Request();
+    outgoingRequest.method = "GET";
+    outgoingRequest.target.ParseFromString("http://www.example.com:1234/bar");
+    auto transaction2 = client.Request(outgoingRequest, true);
+    ASSERT_TRUE(transport->AwaitConnections(1));
+    ASSERT_EQ((size_t)1, transport->connections.size());
+    const auto& connection = transport->connections[0];
+    ASSERT_TRUE(connection->AwaitRequests(2));
+    EXPECT_EQ((std::vector< std::string >{"", "foo"}), connection->requests[0].target.GetPath());
+    EXPECT_EQ((std::vector< std::string >{"", "bar"}), connection->requests[1].target.GetPath());
+    EXPECT_FALSE(connection->requests[0].headers.HasHeaderToken("Connection", "Close"));
+    EXPECT_FALSE(connection->requests[1].headers.HasHeaderToken("Connection", "Close"));
+
+    // Provide both responses back to the client in a single piece,
+    // in the same order the requests were sent.
+    Http::Response response;
+    response.statusCode = 200;
+    response.reasonPhrase = "OK";
+    response.headers.SetHeader("Content-Type", "text/plain");
+    response.headers.SetHeader("Content-Length", "8");
+    response.body = "PogChamp";
+    auto responseEncodings = response.Generate();
+    response = Http::Response();
+    response.statusCode = 200;
+    response.reasonPhrase = "OK";
+    response.headers.SetHeader("Content-Type", "text/plain");
+    response.headers.SetHeader("Content-Length", "7");
+    response.body = "Poggers";
+    responseEncodings += response.Generate();
+    connection->dataReceivedDelegate({responseEncodings.begin(), responseEncodings.end()});
+
+    // Wait for both client transactions to complete, and expect the
+    // responses to have been matched to the requests in the order the
+    // requests were sent.
+    ASSERT_TRUE(transaction1->AwaitCompletion(std::chrono::milliseconds(100)));
+    ASSERT_TRUE(transaction2->AwaitCompletion(std::chrono::milliseconds(100)));
+    EXPECT_EQ(Http::Client::Transaction::State::Completed, transaction1->state);
+    EXPECT_EQ(Http::Client::Transaction::State::Completed, transaction2->state);
+    EXPECT_EQ("PogChamp", transaction1->response.body);
+    EXPECT_EQ("Poggers", transaction2->response.body);
+    EXPECT_FALSE(connection->broken);
+}
+
+TEST_F(ClientTests, RequestManyGroupsRequestsByOriginAndSupportsAggregateWaits) {
+    // Set up the client, allowing only one connection per server,
+    // with up to two requests in flight on it at the same time.
+    const auto transport = std::make_shared< MockTransport >();
+    transport->connectionsAllowed = 2;
+    Http::Client::MobilizationDependencies deps;
+    deps.transport = transport;
+    deps.timeKeeper = std::make_shared< MockTimeKeeper >();
+    deps.maxConnectionsPerServer = 1;
+    deps.maxPipelineDepth = 2;
+    client.Mobilize(deps);
+
+    // Have the client make three GET requests in one batch, two of them
+    // to the same server, interleaved with one to another server.
+    // Expect only one connection per server to be opened, with the two
+    // requests to the same server sharing a connection, and the
+    // transactions returned in the same order as the requests.
+    std::vector< Http::Request > outgoingRequests(3);
+    outgoingRequests[0].method = "GET";
+    outgoingRequests[0].target.ParseFromString("http://www.example.com:1234/foo");
+    outgoingRequests[1].method = "GET";
+    outgoingRequests[1].target.ParseFromString("http://other.example.com:1234/spam");
+    outgoingRequests[2].method = "GET";
+    outgoingRequests[2].target.ParseFromString("http://www.example.com:1234/bar");
+    const auto transactions = client.RequestMany(outgoingRequests, true);
+    ASSERT_EQ((size_t)3, transactions.size());
+    ASSERT_TRUE(transport->AwaitConnections(2));
+    ASSERT_EQ((size_t)2, transport->connections.size());
+    std::shared_ptr< MockConnection > sharedConnection, otherConnection;
+    for (const auto& connection: transport->connections) {
+        if (connection->hostNameOrIpAddress == "www.example.com") {
+            sharedConnection = connection;
+        } else {
+            otherConnection = connection;
+        }
+    }
+    ASSERT_FALSE(sharedConnection == nullptr);
+    ASSERT_FALSE(otherConnection == nullptr);
+    ASSERT_TRUE(sharedConnection->AwaitRequests(2));
+    EXPECT_EQ((std::vector< std::string >{"", "foo"}), sharedConnection->requests[0].target.GetPath());
+    EXPECT_EQ((std::vector< std::string >{"", "bar"}), sharedConnection->requests[1].target.GetPath());
+    ASSERT_TRUE(otherConnection->AwaitRequests(1));
+    EXPECT_EQ((std::vector< std::string >{"", "spam"}), otherConnection->requests[0].target.GetPath());
+
+    // While no responses have been provided, neither aggregate wait
+    // should indicate completion.
+    EXPECT_FALSE(
+        Http::Client::AwaitAllCompletions(
+            transactions,
+            std::chrono::milliseconds(0)
+        )
+    );
+
+    // Provide a response back to the client for the request made to the
+    // second server only, and expect the await-any wait to single out
+    // the corresponding transaction.
+    Http::Response response;
+    response.statusCode = 200;
+    response.reasonPhrase = "OK";
+    response.headers.SetHeader("Content-Type", "text/plain");
+    response.headers.SetHeader("Content-Length", "8");
+    response.body = "PogChamp";
+    auto responseEncoding = response.Generate();
+    otherConnection->dataReceivedDelegate({responseEncoding.begin(), responseEncoding.end()});
+    EXPECT_EQ(
+        (size_t)1,
+        Http::Client::AwaitAnyCompletion(
+            transactions,
+            std::chrono::milliseconds(100)
+        )
+    );
+    EXPECT_EQ("PogChamp", transactions[1]->response.body);
+
+    // Provide responses for the two pipelined requests, and expect the
+    // await-all wait to indicate that every transaction has completed.
+    response = Http::Response();
+    response.statusCode = 200;
+    response.reasonPhrase = "OK";
+    response.headers.SetHeader("Content-Type", "text/plain");
+    response.headers.SetHeader("Content-Length", "7");
+    response.body = "Poggers";
+    responseEncoding = response.Generate();
+    sharedConnection->dataReceivedDelegate({responseEncoding.begin(), responseEncoding.end()});
+    response = Http::Response();
+    response.statusCode = 200;
+    response.reasonPhrase = "OK";
+    response.headers.SetHeader("Content-Type", "text/plain");
+    response.headers.SetHeader("Content-Length", "5");
+    response.body = "Kappa";
+    responseEncoding = response.Generate();
+    sharedConnection->dataReceivedDelegate({responseEncoding.begin(), responseEncoding.end()});
+    EXPECT_TRUE(
+        Http::Client::AwaitAllCompletions(
+            transactions,
+            std::chrono::milliseconds(100)
+        )
+    );
+    EXPECT_EQ("Poggers", transactions[0]->response.body);
+    EXPECT_EQ("Kappa", transactions[2]->response.body);
+}
+
+TEST_F(ClientTests, PipelinedRequestReplayedAfterConnectionLost) {
+    // Set up the client, allowing only one persistent connection
+    // per server, with up to two requests in flight on it at the
+    // same time.
+    const auto transport = std::make_shared< MockTransport >();
+    transport->connectionsAllowed = 2;
+    Http::Client::MobilizationDependencies deps;
+    deps.transport = transport;
+    deps.timeKeeper = std::make_shared< MockTimeKeeper >();
+    deps.maxConnectionsPerServer = 1;
+    deps.maxPipelineDepth = 2;
+    client.Mobilize(deps);
+
+    // Have the client make two concurrent GET requests to the same server,
+    // and expect the second to be pipelined behind the first.
+    Http::Request outgoingRequest;
+    outgoingRequest.method = "GET";
+    outgoingRequest.target.ParseFromString("http://www.example.com:1234/foo");
+    auto transaction1 = client.Request(outgoingRequest, true);
+    outgoingRequest = Http::Request();
+    outgoingRequest.method = "GET";
+    outgoingRequest.target.ParseFromString("http://www.example.com:1234/bar");
+    auto transaction2 = client.Request(outgoingRequest, true);
+    ASSERT_EQ((size_t)1, transport->connections.size());
+    const auto& connection1 = transport->connections[0];
+    ASSERT_TRUE(connection1->AwaitRequests(2));
+
+    // Break the connection from the server end before any response is
+    // received.  Expect the first transaction to fail, but the second,
+    // which was still waiting in the pipeline, to be sent again through
+    // a new connection.
+    connection1->brokenDelegate(false);
+    ASSERT_TRUE(transaction1->AwaitCompletion(std::chrono::milliseconds(100)));
+    EXPECT_EQ(Http::Client::Transaction::State::Broken, transaction1->state);
+    ASSERT_TRUE(transport->AwaitConnections(2));
+    const auto& connection2 = transport->connections[1];
+    ASSERT_TRUE(connection2->AwaitRequests(1));
+    EXPECT_EQ((std::vector< std::string >{"", "bar"}), connection2->requests[0].target.GetPath());
+
+    // Provide a response back to the client through the new connection,
+    // and expect the second transaction to complete normally.
+    Http::Response response;
+    response.statusCode = 200;
+    response.reasonPhrase = "OK";
+    response.headers.SetHeader("Content-Type", "text/plain");
+    response.headers.SetHeader("Content-Length", "7");
+    response.body = "Poggers";
+    const auto responseEncoding = response.Generate();
+    connection2->dataReceivedDelegate({responseEncoding.begin(), responseEncoding.end()});
+    ASSERT_TRUE(transaction2->AwaitCompletion(std::chrono::milliseconds(100)));
+    EXPECT_EQ(Http::Client::Transaction::State::Completed, transaction2->state);
+    EXPECT_EQ("Poggers", transaction2->response.body);
+
+    // The replacement connection wasn't pooled, so expect the client
+    // to have closed it once the replayed transaction completed.
+    EXPECT_TRUE(connection2->AwaitBroken());
+}
+
 TEST_F(ClientTests, SecondRequestNonPersistentWithPersistentConnectionClosesConnection) {
     // Set up the client.
     const auto transport = std::make_shared< MockTransport >();
@@ -57,3 +57,48 @@ TEST(ResponseTests, GenerateGetResponse) {
         response.Generate()
     );
 }
+
+TEST(ResponseTests, GenerateWithNonStandardStatus) {
+    Http::Response response;
+    response.statusCode = 599;
+    response.reasonPhrase = "Pretty Bad";
+    response.headers.AddHeader("Content-Type", "text/plain");
+    ASSERT_EQ(
+        "HTTP/1.1 599 Pretty Bad\r\n"
+        "Content-Type: text/plain\r\n"
+        "\r\n",
+        response.Generate()
+    );
+}
+
+TEST(ResponseTests, GenerateWithNonStandardReasonPhrase) {
+    Http::Response response;
+    response.statusCode = 404;
+    response.reasonPhrase = "Nothing To See Here";
+    ASSERT_EQ(
+        "HTTP/1.1 404 Nothing To See Here\r\n"
+        "\r\n",
+        response.Generate()
+    );
+}
+
+TEST(ResponseTests, GenerateToLeavesOutBody) {
+    Http::Response response;
+    response.statusCode = 200;
+    response.reasonPhrase = "OK";
+    response.headers.AddHeader("Content-Type", "text/plain");
+    response.body = "Hello World!";
+    response.headers.AddHeader("Content-Length", StringExtensions::sprintf("%zu", response.body.size()));
+    std::string head = "stale contents from a previous response";
+    response.GenerateTo(head);
+    ASSERT_EQ(
+        StringExtensions::sprintf(
+            "HTTP/1.1 200 OK\r\n"
+            "Content-Type: text/plain\r\n"
+            "Content-Length: %zu\r\n"
+            "\r\n",
+            response.body.size()
+        ),
+        head
+    );
+}
@@ -8,12 +8,15 @@
  */
 
 #include <condition_variable>
+#include <fstream>
 #include <future>
 #include <gtest/gtest.h>
 #include <Http/Client.hpp>
 #include <Http/Server.hpp>
 #include <inttypes.h>
 #include <limits>
+#include <mutex>
+#include <stdio.h>
 #include <StringExtensions/StringExtensions.hpp>
 #include <SystemAbstractions/DiagnosticsSender.hpp>
 #include <thread>
@@ -67,6 +70,21 @@ namespace {
          */
         bool broken = false;
 
+        /**
+         * This is the value to return for the size of the send queue.
+         */
+        size_t sendQueueSize = 0;
+
+        /**
+         * This is the delegate set through SetWritableDelegate, if any.
+         */
+        WritableDelegate writableDelegate;
+
+        /**
+         * This is the low watermark given through SetWritableDelegate.
+         */
+        size_t lowWatermark = 0;
+
         /**
          * This flag indicates whether or not the remote peer broke
          * the connection gracefully.
@@ -160,6 +178,20 @@ namespace {
             waitCondition.notify_all();
         }
 
+        virtual size_t GetSendQueueSize() override {
+            std::lock_guard< decltype(mutex) > lock(mutex);
+            return sendQueueSize;
+        }
+
+        virtual void SetWritableDelegate(
+            WritableDelegate newWritableDelegate,
+            size_t newLowWatermark
+        ) override {
+            std::lock_guard< decltype(mutex) > lock(mutex);
+            writableDelegate = newWritableDelegate;
+            lowWatermark = newLowWatermark;
+        }
+
         virtual void Break(bool clean) override {
             std::lock_guard< decltype(mutex) > lock(mutex);
             broken = true;
@@ -336,6 +368,17 @@ TEST_F(ServerTests, ParseGetRequest_ASCII_Target_URI) {
     ASSERT_TRUE(request->body.empty());
 }
 
+TEST_F(ServerTests, ParseGetRequestKeepsRawTarget) {
+    const auto request = server.ParseRequest(
+        "GET /hello.txt?foo=bar%20spam HTTP/1.1\r\n"
+        "Host: www.example.com\r\n"
+        "\r\n"
+    );
+    ASSERT_FALSE(request == nullptr);
+    ASSERT_EQ(Http::Request::State::Complete, request->state);
+    EXPECT_EQ("/hello.txt?foo=bar%20spam", request->rawTarget);
+}
+
 TEST_F(ServerTests, ParseGetRequest_Non_ASCII_Target_URI) {
     const auto request = server.ParseRequest(
         "GET /%F0%9F%92%A9.txt HTTP/1.1\r\n"
@@ -642,6 +685,52 @@ TEST_F(ServerTests, MobilizeRandomPort) {
     );
 }
 
+TEST_F(ServerTests, MobilizeMultipleAcceptorTransports) {
+    // Mobilize the server with one extra acceptor transport, using a
+    // port of zero so that the system gets to choose the port.
+    auto transport = std::make_shared< MockTransport >();
+    auto extraTransport = std::make_shared< MockTransport >();
+    Http::Server::MobilizationDependencies deps;
+    deps.transport = transport;
+    deps.transports.push_back(extraTransport);
+    deps.timeKeeper = std::make_shared< MockTimeKeeper >();
+    server.SetConfigurationItem("Port", "0");
+    ASSERT_TRUE(server.Mobilize(deps));
+
+    // Expect both transports to be bound to the port chosen when the
+    // first transport was bound.
+    ASSERT_TRUE(transport->bound);
+    ASSERT_TRUE(extraTransport->bound);
+    EXPECT_EQ(1234, transport->port);
+    EXPECT_EQ(1234, extraTransport->port);
+    EXPECT_EQ("1234", server.GetConfigurationItem("Port"));
+    ASSERT_FALSE(extraTransport->connectionDelegate == nullptr);
+
+    // Expect a connection accepted through the extra transport to be
+    // served like any other.
+    auto connection = std::make_shared< MockConnection >();
+    extraTransport->connectionDelegate(connection);
+    ASSERT_FALSE(connection->dataReceivedDelegate == nullptr);
+    const std::string request = (
+        "GET /hello.txt HTTP/1.1\r\n"
+        "Host: www.example.com\r\n"
+        "\r\n"
+    );
+    connection->dataReceivedDelegate(
+        std::vector< uint8_t >(
+            request.begin(),
+            request.end()
+        )
+    );
+    EXPECT_FALSE(connection->dataReceived.empty());
+
+    // Expect both transports to be released when the server
+    // is demobilized.
+    server.Demobilize();
+    EXPECT_FALSE(transport->bound);
+    EXPECT_FALSE(extraTransport->bound);
+}
+
 TEST_F(ServerTests, Demobilize) {
     auto transport = std::make_shared< MockTransport >();
     bool timeKeeperReleased = false;
@@ -731,6 +820,66 @@ TEST_F(ServerTests, ClientRequestInOnePiece) {
     );
 }
 
+TEST_F(ServerTests, AsyncDiagnosticsPublishRequestReportsOffTheRequestPath) {
+    auto transport = std::make_shared< MockTransport >();
+    Http::Server::MobilizationDependencies deps;
+    deps.transport = transport;
+    deps.timeKeeper = std::make_shared< MockTimeKeeper >();
+    server.SetConfigurationItem("Port", "1234");
+    server.SetConfigurationItem("AsyncDiagnostics", "1");
+    (void)server.Mobilize(deps);
+    std::mutex reportsMutex;
+    std::condition_variable reportsWaitCondition;
+    std::vector< std::string > requestReports;
+    const auto unsubscribe = server.SubscribeToDiagnostics(
+        [&reportsMutex, &reportsWaitCondition, &requestReports](
+            std::string senderName,
+            size_t level,
+            std::string message
+        ){
+            std::lock_guard< std::mutex > lock(reportsMutex);
+            if (message.substr(0, 9) == "Request: ") {
+                requestReports.push_back(message);
+                reportsWaitCondition.notify_all();
+            }
+        },
+        1
+    );
+    auto connection = std::make_shared< MockConnection >();
+    transport->connectionDelegate(connection);
+    ASSERT_FALSE(connection->dataReceivedDelegate == nullptr);
+    const std::string request = (
+        "GET /hello.txt HTTP/1.1\r\n"
+        "Host: www.example.com\r\n"
+        "\r\n"
+    );
+    connection->dataReceivedDelegate(
+        std::vector< uint8_t >(
+            request.begin(),
+            request.end()
+        )
+    );
+
+    // The response is issued on the request path, but the request
+    // report is formatted and published by the reaper thread,
+    // so wait for it to come through.
+    {
+        std::unique_lock< std::mutex > lock(reportsMutex);
+        ASSERT_TRUE(
+            reportsWaitCondition.wait_for(
+                lock,
+                std::chrono::seconds(1),
+                [&requestReports]{ return !requestReports.empty(); }
+            )
+        );
+        EXPECT_EQ(
+            "Request: GET '/hello.txt' (0) from mock-client:5555: 404 (text/plain:13)",
+            requestReports[0]
+        );
+    }
+    unsubscribe();
+}
+
 TEST_F(ServerTests, ClientRequestInTwoPieces) {
     auto transport = std::make_shared< MockTransport >();
     Http::Server::MobilizationDependencies deps;
@@ -1284,6 +1433,461 @@ TEST_F(ServerTests, RegisterResourceDelegateServerWide) {
     connection->dataReceived.clear();
 }
 
+TEST_F(ServerTests, RegisterStreamedResourceDelegate) {
+    auto transport = std::make_shared< MockTransport >();
+    Http::Server::MobilizationDependencies deps;
+    deps.transport = transport;
+    deps.timeKeeper = std::make_shared< MockTimeKeeper >();
+    server.SetConfigurationItem("Port", "1234");
+    (void)server.Mobilize(deps);
+    auto connection = std::make_shared< MockConnection >();
+    transport->connectionDelegate(connection);
+
+    // Register a streamed resource delegate which sends its headers
+    // immediately and holds onto the response writer, so that the body
+    // can be streamed after the delegate returns.
+    std::shared_ptr< Http::IServer::ResponseWriter > writer;
+    const auto streamedResourceDelegate = [&writer](
+        const Http::Request& request,
+        std::shared_ptr< Http::IServer::ResponseWriter > responseWriter
+    ){
+        Http::Response response;
+        response.statusCode = 200;
+        response.reasonPhrase = "OK";
+        response.headers.SetHeader("Content-Type", "text/plain");
+        responseWriter->SendResponseHeaders(response);
+        writer = responseWriter;
+    };
+    const auto unregistrationDelegate = server.RegisterStreamedResource(
+        { "events" },
+        streamedResourceDelegate
+    );
+
+    // Query the resource, and expect the status line and headers to be
+    // sent back immediately, before any of the body, with the chunked
+    // transfer coding selected since the delegate set no "Content-Length".
+    const std::string request = (
+        "GET /events HTTP/1.1\r\n"
+        "Host: www.example.com\r\n"
+        "\r\n"
+    );
+    connection->dataReceivedDelegate(
+        std::vector< uint8_t >(
+            request.begin(),
+            request.end()
+        )
+    );
+    ASSERT_FALSE(writer == nullptr);
+    EXPECT_EQ(
+        "HTTP/1.1 200 OK\r\n"
+        "Content-Type: text/plain\r\n"
+        "Transfer-Encoding: chunked\r\n"
+        "\r\n",
+        std::string(
+            connection->dataReceived.begin(),
+            connection->dataReceived.end()
+        )
+    );
+    connection->dataReceived.clear();
+
+    // Stream two pieces of the body, and expect each to be sent to the
+    // client as its own chunk, as soon as it's written.
+    writer->SendBodyChunk("Hello, World!");
+    EXPECT_EQ(
+        "d\r\nHello, World!\r\n",
+        std::string(
+            connection->dataReceived.begin(),
+            connection->dataReceived.end()
+        )
+    );
+    connection->dataReceived.clear();
+    writer->SendBodyChunk("Goodbye!");
+    EXPECT_EQ(
+        "8\r\nGoodbye!\r\n",
+        std::string(
+            connection->dataReceived.begin(),
+            connection->dataReceived.end()
+        )
+    );
+    connection->dataReceived.clear();
+
+    // Finish the response, and expect the last-chunk marker to be sent,
+    // with the connection left open for more requests.
+    writer->FinishResponse();
+    EXPECT_EQ(
+        "0\r\n\r\n",
+        std::string(
+            connection->dataReceived.begin(),
+            connection->dataReceived.end()
+        )
+    );
+    EXPECT_FALSE(connection->broken);
+    connection->dataReceived.clear();
+
+    // Query the resource a second time, to make sure the server resumed
+    // processing requests on the connection after the streamed
+    // response finished.
+    writer = nullptr;
+    connection->dataReceivedDelegate(
+        std::vector< uint8_t >(
+            request.begin(),
+            request.end()
+        )
+    );
+    ASSERT_FALSE(writer == nullptr);
+    writer->FinishResponse();
+}
+
+TEST_F(ServerTests, StreamedResourceResponseAbandonedWhenConnectionBroken) {
+    auto transport = std::make_shared< MockTransport >();
+    Http::Server::MobilizationDependencies deps;
+    deps.transport = transport;
+    deps.timeKeeper = std::make_shared< MockTimeKeeper >();
+    server.SetConfigurationItem("Port", "1234");
+    (void)server.Mobilize(deps);
+    auto connection = std::make_shared< MockConnection >();
+    transport->connectionDelegate(connection);
+
+    // Register a streamed resource delegate which holds onto the response
+    // writer, asking to be told if the connection is broken before
+    // the response is finished.
+    bool abandoned = false;
+    std::shared_ptr< Http::IServer::ResponseWriter > writer;
+    const auto unregistrationDelegate = server.RegisterStreamedResource(
+        { "events" },
+        [&abandoned, &writer](
+            const Http::Request& request,
+            std::shared_ptr< Http::IServer::ResponseWriter > responseWriter
+        ){
+            Http::Response response;
+            response.statusCode = 200;
+            response.reasonPhrase = "OK";
+            responseWriter->SendResponseHeaders(response);
+            responseWriter->SetAbandonedDelegate(
+                [&abandoned]{ abandoned = true; }
+            );
+            writer = responseWriter;
+        }
+    );
+
+    // Query the resource, and then break the connection from the client
+    // end before the response is finished.  Expect the delegate to be
+    // told that the response was abandoned.
+    const std::string request = (
+        "GET /events HTTP/1.1\r\n"
+        "Host: www.example.com\r\n"
+        "\r\n"
+    );
+    connection->dataReceivedDelegate(
+        std::vector< uint8_t >(
+            request.begin(),
+            request.end()
+        )
+    );
+    ASSERT_FALSE(writer == nullptr);
+    EXPECT_FALSE(abandoned);
+    connection->brokenDelegate(false);
+    EXPECT_TRUE(abandoned);
+}
+
+TEST_F(ServerTests, StreamedResourceSendQueueVisibleThroughResponseWriter) {
+    auto transport = std::make_shared< MockTransport >();
+    Http::Server::MobilizationDependencies deps;
+    deps.transport = transport;
+    deps.timeKeeper = std::make_shared< MockTimeKeeper >();
+    server.SetConfigurationItem("Port", "1234");
+    server.SetConfigurationItem("SendQueueLowWatermark", "1024");
+    (void)server.Mobilize(deps);
+    auto connection = std::make_shared< MockConnection >();
+    transport->connectionDelegate(connection);
+
+    // Register a streamed resource delegate which holds onto the
+    // response writer, asking to be told when the connection becomes
+    // writable again.
+    bool writable = false;
+    std::shared_ptr< Http::IServer::ResponseWriter > writer;
+    const auto unregistrationDelegate = server.RegisterStreamedResource(
+        { "events" },
+        [&writable, &writer](
+            const Http::Request& request,
+            std::shared_ptr< Http::IServer::ResponseWriter > responseWriter
+        ){
+            Http::Response response;
+            response.statusCode = 200;
+            response.reasonPhrase = "OK";
+            responseWriter->SendResponseHeaders(response);
+            responseWriter->SetWritableDelegate(
+                [&writable]{ writable = true; }
+            );
+            writer = responseWriter;
+        }
+    );
+
+    // Query the resource, and expect the writable delegate to have been
+    // handed to the connection along with the configured low watermark.
+    const std::string request = (
+        "GET /events HTTP/1.1\r\n"
+        "Host: www.example.com\r\n"
+        "\r\n"
+    );
+    connection->dataReceivedDelegate(
+        std::vector< uint8_t >(
+            request.begin(),
+            request.end()
+        )
+    );
+    ASSERT_FALSE(writer == nullptr);
+    ASSERT_FALSE(connection->writableDelegate == nullptr);
+    EXPECT_EQ((size_t)1024, connection->lowWatermark);
+
+    // Expect the response writer to report the send queue size of
+    // the connection.
+    EXPECT_EQ((size_t)0, writer->GetSendQueueSize());
+    connection->sendQueueSize = 4096;
+    EXPECT_EQ((size_t)4096, writer->GetSendQueueSize());
+
+    // Simulate the send queue draining back down to the low watermark,
+    // and expect the handler to be told through its writable delegate.
+    connection->sendQueueSize = 1024;
+    EXPECT_FALSE(writable);
+    connection->writableDelegate();
+    EXPECT_TRUE(writable);
+    writer->FinishResponse();
+}
+
+TEST_F(ServerTests, RegisterStreamedRequestResourceDelegate) {
+    auto transport = std::make_shared< MockTransport >();
+    Http::Server::MobilizationDependencies deps;
+    deps.transport = transport;
+    deps.timeKeeper = std::make_shared< MockTimeKeeper >();
+    server.SetConfigurationItem("Port", "1234");
+    (void)server.Mobilize(deps);
+    auto connection = std::make_shared< MockConnection >();
+    transport->connectionDelegate(connection);
+
+    // Register a streamed request delegate which collects the pieces
+    // of the request body as they're delivered.
+    std::vector< std::string > bodyPieces;
+    bool bodyEnded = false;
+    std::shared_ptr< Http::IServer::ResponseWriter > writer;
+    const auto unregistrationDelegate = server.RegisterStreamedRequestResource(
+        { "uploads" },
+        [&bodyPieces, &bodyEnded, &writer](
+            const Http::Request& request,
+            std::shared_ptr< Http::IServer::RequestReader > requestReader,
+            std::shared_ptr< Http::IServer::ResponseWriter > responseWriter
+        ){
+            requestReader->SetBodyDelegate(
+                [&bodyPieces](const std::string& bodyData){
+                    bodyPieces.push_back(bodyData);
+                }
+            );
+            requestReader->SetBodyEndDelegate(
+                [&bodyEnded]{ bodyEnded = true; }
+            );
+            writer = responseWriter;
+        }
+    );
+
+    // Send the headers of an upload request, and expect the delegate
+    // to be called as soon as they arrive, before any of the body.
+    const std::string requestHeaders = (
+        "POST /uploads HTTP/1.1\r\n"
+        "Host: www.example.com\r\n"
+        "Content-Length: 10\r\n"
+        "\r\n"
+    );
+    connection->dataReceivedDelegate(
+        std::vector< uint8_t >(
+            requestHeaders.begin(),
+            requestHeaders.end()
+        )
+    );
+    ASSERT_FALSE(writer == nullptr);
+    EXPECT_TRUE(bodyPieces.empty());
+    EXPECT_FALSE(bodyEnded);
+
+    // Send the body in two pieces, and expect each piece to be delivered
+    // to the delegate as it arrives.
+    const std::string bodyFirstPiece = "Hello";
+    connection->dataReceivedDelegate(
+        std::vector< uint8_t >(
+            bodyFirstPiece.begin(),
+            bodyFirstPiece.end()
+        )
+    );
+    EXPECT_EQ(
+        (std::vector< std::string >{ "Hello" }),
+        bodyPieces
+    );
+    EXPECT_FALSE(bodyEnded);
+    const std::string bodySecondPiece = "World";
+    connection->dataReceivedDelegate(
+        std::vector< uint8_t >(
+            bodySecondPiece.begin(),
+            bodySecondPiece.end()
+        )
+    );
+    EXPECT_EQ(
+        (std::vector< std::string >{ "Hello", "World" }),
+        bodyPieces
+    );
+    EXPECT_TRUE(bodyEnded);
+
+    // Finish the response, and expect the connection to be left open
+    // for more requests.
+    Http::Response response;
+    response.statusCode = 200;
+    response.reasonPhrase = "OK";
+    response.headers.SetHeader("Content-Length", "0");
+    writer->SendResponseHeaders(response);
+    writer->FinishResponse();
+    EXPECT_EQ(
+        "HTTP/1.1 200 OK\r\n"
+        "Content-Length: 0\r\n"
+        "\r\n",
+        std::string(
+            connection->dataReceived.begin(),
+            connection->dataReceived.end()
+        )
+    );
+    EXPECT_FALSE(connection->broken);
+}
+
+TEST_F(ServerTests, ChunkedUploadNotClaimedByStreamedRequestHandler) {
+    auto transport = std::make_shared< MockTransport >();
+    Http::Server::MobilizationDependencies deps;
+    deps.transport = transport;
+    deps.timeKeeper = std::make_shared< MockTimeKeeper >();
+    server.SetConfigurationItem("Port", "1234");
+    (void)server.Mobilize(deps);
+    auto connection = std::make_shared< MockConnection >();
+    transport->connectionDelegate(connection);
+
+    // Register a streamed request delegate.
+    bool handlerCalled = false;
+    const auto unregistrationDelegate = server.RegisterStreamedRequestResource(
+        { "uploads" },
+        [&handlerCalled](
+            const Http::Request& request,
+            std::shared_ptr< Http::IServer::RequestReader > requestReader,
+            std::shared_ptr< Http::IServer::ResponseWriter > responseWriter
+        ){
+            handlerCalled = true;
+        }
+    );
+
+    // Send the headers of an upload framed with the chunked transfer
+    // coding.  The body has no predetermined length, so the streamed
+    // request path can't claim it; expect the request to go through
+    // the buffered parsing path instead, without the client getting
+    // banned for the chunk-size lines being misread as request lines.
+    const std::string requestHeaders = (
+        "POST /uploads HTTP/1.1\r\n"
+        "Host: www.example.com\r\n"
+        "Transfer-Encoding: chunked\r\n"
+        "\r\n"
+    );
+    connection->dataReceivedDelegate(
+        std::vector< uint8_t >(
+            requestHeaders.begin(),
+            requestHeaders.end()
+        )
+    );
+    EXPECT_FALSE(handlerCalled);
+    EXPECT_EQ(
+        (std::set< std::string >{}),
+        server.GetBans()
+    );
+}
+
+TEST_F(ServerTests, StreamedRequestBodyDeliveryBackpressure) {
+    auto transport = std::make_shared< MockTransport >();
+    Http::Server::MobilizationDependencies deps;
+    deps.transport = transport;
+    deps.timeKeeper = std::make_shared< MockTimeKeeper >();
+    server.SetConfigurationItem("Port", "1234");
+    (void)server.Mobilize(deps);
+    auto connection = std::make_shared< MockConnection >();
+    transport->connectionDelegate(connection);
+
+    // Register a streamed request delegate which pauses the reader
+    // after each piece of the body it's given, as a handler writing
+    // the body out to slower storage would.
+    std::vector< std::string > bodyPieces;
+    bool bodyEnded = false;
+    std::shared_ptr< Http::IServer::RequestReader > reader;
+    const auto unregistrationDelegate = server.RegisterStreamedRequestResource(
+        { "uploads" },
+        [&bodyPieces, &bodyEnded, &reader](
+            const Http::Request& request,
+            std::shared_ptr< Http::IServer::RequestReader > requestReader,
+            std::shared_ptr< Http::IServer::ResponseWriter > responseWriter
+        ){
+            reader = requestReader;
+            requestReader->SetBodyDelegate(
+                [&bodyPieces, &reader](const std::string& bodyData){
+                    bodyPieces.push_back(bodyData);
+                    reader->Pause();
+                }
+            );
+            requestReader->SetBodyEndDelegate(
+                [&bodyEnded]{ bodyEnded = true; }
+            );
+        }
+    );
+
+    // Send the headers of an upload request followed by the first piece
+    // of the body, which pauses delivery.
+    const std::string requestHeaders = (
+        "POST /uploads HTTP/1.1\r\n"
+        "Host: www.example.com\r\n"
+        "Content-Length: 10\r\n"
+        "\r\n"
+    );
+    connection->dataReceivedDelegate(
+        std::vector< uint8_t >(
+            requestHeaders.begin(),
+            requestHeaders.end()
+        )
+    );
+    const std::string bodyFirstPiece = "Hello";
+    connection->dataReceivedDelegate(
+        std::vector< uint8_t >(
+            bodyFirstPiece.begin(),
+            bodyFirstPiece.end()
+        )
+    );
+    EXPECT_EQ(
+        (std::vector< std::string >{ "Hello" }),
+        bodyPieces
+    );
+
+    // Send the rest of the body, and expect it to be held by the server,
+    // not delivered, since delivery is paused.
+    const std::string bodySecondPiece = "World";
+    connection->dataReceivedDelegate(
+        std::vector< uint8_t >(
+            bodySecondPiece.begin(),
+            bodySecondPiece.end()
+        )
+    );
+    EXPECT_EQ(
+        (std::vector< std::string >{ "Hello" }),
+        bodyPieces
+    );
+    EXPECT_FALSE(bodyEnded);
+
+    // Resume delivery, and expect the held piece of the body to be
+    // delivered, completing the body.
+    reader->Resume();
+    EXPECT_EQ(
+        (std::vector< std::string >{ "Hello", "World" }),
+        bodyPieces
+    );
+    EXPECT_TRUE(bodyEnded);
+}
+
 TEST_F(ServerTests, UnRegisterResourceDelegateServerWideWhenSubspaceStillRegistered) {
     // Setup
     auto transport = std::make_shared< MockTransport >();
@@ -2538,6 +3142,87 @@ TEST_F(ServerTests, TooManyRequestsResultsInBan) {
     EXPECT_FALSE(connection->broken);
 }
 
+TEST_F(ServerTests, AcceptlistChangesApplyToEstablishedConnections) {
+    // Set up server.
+    auto transport = std::make_shared< MockTransport >();
+    const auto timeKeeper = std::make_shared< MockTimeKeeper >();
+    Http::Server::MobilizationDependencies deps;
+    deps.transport = transport;
+    deps.timeKeeper = timeKeeper;
+    server.SetConfigurationItem("Port", "1234");
+    server.SetConfigurationItem("InitialBanPeriod", "1.0");
+    server.SetConfigurationItem("TooManyRequestsThreshold", "2.0");
+    server.SetConfigurationItem("TooManyRequestsMeasurementPeriod", "1.0");
+    (void)server.Mobilize(deps);
+
+    // Issue one good request, which isn't enough to get banned,
+    // but leaves no budget for a second rapid request.
+    auto connection = std::make_shared< MockConnection >();
+    transport->connectionDelegate(connection);
+    const std::string request = (
+        "GET / HTTP/1.1\r\n"
+        "Host: www.example.com\r\n"
+        "\r\n"
+    );
+    ASSERT_FALSE(connection->dataReceivedDelegate == nullptr);
+    connection->dataReceivedDelegate(
+        std::vector< uint8_t >(
+            request.begin(),
+            request.end()
+        )
+    );
+    Http::Client client;
+    auto response = client.ParseResponse(
+        std::string(
+            connection->dataReceived.begin(),
+            connection->dataReceived.end()
+        )
+    );
+    ASSERT_FALSE(response == nullptr);
+    EXPECT_NE(429, response->statusCode);
+
+    // Put the client on the acceptlist while its connection is still
+    // up, and expect a second rapid request on the same connection
+    // to no longer be rate limited.
+    server.AcceptlistAdd("mock-client");
+    connection->dataReceived.clear();
+    connection->dataReceivedDelegate(
+        std::vector< uint8_t >(
+            request.begin(),
+            request.end()
+        )
+    );
+    response = client.ParseResponse(
+        std::string(
+            connection->dataReceived.begin(),
+            connection->dataReceived.end()
+        )
+    );
+    ASSERT_FALSE(response == nullptr);
+    EXPECT_NE(429, response->statusCode);
+    EXPECT_FALSE(connection->broken);
+
+    // Take the client back off the acceptlist, and expect a third
+    // rapid request on the same connection to be rate limited again.
+    server.AcceptlistRemove("mock-client");
+    connection->dataReceived.clear();
+    connection->dataReceivedDelegate(
+        std::vector< uint8_t >(
+            request.begin(),
+            request.end()
+        )
+    );
+    response = client.ParseResponse(
+        std::string(
+            connection->dataReceived.begin(),
+            connection->dataReceived.end()
+        )
+    );
+    ASSERT_FALSE(response == nullptr);
+    EXPECT_EQ(429, response->statusCode);
+    EXPECT_TRUE(connection->broken);
+}
+
 TEST_F(ServerTests, MultipleBadRequestsSentAtOnceCausesContinuedProcessingAfterClose) {
     // Set up server.
     auto transport = std::make_shared< MockTransport >();
@@ -3155,6 +3840,209 @@ TEST_F(ServerTests, Unban) {
     EXPECT_FALSE(connection->broken);
 }
 
+TEST_F(ServerTests, MetricsSnapshotCountsTraffic) {
+    // Arrange
+    auto transport = std::make_shared< MockTransport >();
+    Http::Server::MobilizationDependencies deps;
+    deps.transport = transport;
+    deps.timeKeeper = std::make_shared< MockTimeKeeper >();
+    (void)server.Mobilize(deps);
+    const auto unregistrationDelegate = server.RegisterResource(
+        {"foo"},
+        [](
+            const Http::Request& request,
+            std::shared_ptr< Http::Connection > connection,
+            const std::string& trailer
+        ){
+            Http::Response response;
+            response.statusCode = 200;
+            response.reasonPhrase = "OK";
+            return response;
+        }
+    );
+    auto connection = std::make_shared< MockConnection >();
+    transport->connectionDelegate(connection);
+
+    // Act
+    const std::string request = (
+        "GET /foo HTTP/1.1\r\n"
+        "Host: www.example.com\r\n"
+        "\r\n"
+    );
+    connection->dataReceivedDelegate(
+        std::vector< uint8_t >(
+            request.begin(),
+            request.end()
+        )
+    );
+
+    // Assert
+    const auto snapshot = server.GetMetricsSnapshot();
+    EXPECT_EQ((size_t)1, snapshot.activeConnections);
+    EXPECT_EQ((size_t)1, snapshot.requestsReceived);
+    EXPECT_EQ((size_t)1, snapshot.responsesSuccess);
+    EXPECT_EQ((size_t)0, snapshot.responsesClientError);
+    EXPECT_EQ(request.length(), snapshot.bytesReceived);
+    ASSERT_FALSE(connection->dataReceived.empty());
+    EXPECT_EQ(connection->dataReceived.size(), snapshot.bytesSent);
+    EXPECT_EQ((size_t)0, snapshot.bansIssued);
+}
+
+TEST_F(ServerTests, FileBodyResponseSentThroughConnection) {
+    // Arrange
+    const std::string filePath = "ServerTestsFileBody.txt";
+    {
+        std::ofstream file(filePath, std::ios::binary);
+        file << "Hello, File!";
+    }
+    auto transport = std::make_shared< MockTransport >();
+    Http::Server::MobilizationDependencies deps;
+    deps.transport = transport;
+    deps.timeKeeper = std::make_shared< MockTimeKeeper >();
+    (void)server.Mobilize(deps);
+    const auto unregistrationDelegate = server.RegisterResource(
+        {"foo"},
+        [filePath](
+            const Http::Request& request,
+            std::shared_ptr< Http::Connection > connection,
+            const std::string& trailer
+        ){
+            Http::Response response;
+            response.statusCode = 200;
+            response.reasonPhrase = "OK";
+            response.fileBody.path = filePath;
+            response.fileBody.offset = 7;
+            response.fileBody.length = 5;
+            return response;
+        }
+    );
+    auto connection = std::make_shared< MockConnection >();
+    transport->connectionDelegate(connection);
+
+    // Act
+    const std::string request = (
+        "GET /foo HTTP/1.1\r\n"
+        "Host: www.example.com\r\n"
+        "\r\n"
+    );
+    connection->dataReceivedDelegate(
+        std::vector< uint8_t >(
+            request.begin(),
+            request.end()
+        )
+    );
+
+    // Assert
+    const std::string responseText(
+        connection->dataReceived.begin(),
+        connection->dataReceived.end()
+    );
+    EXPECT_FALSE(connection->broken);
+    EXPECT_NE(std::string::npos, responseText.find("Content-Length: 5\r\n"));
+    ASSERT_GE(responseText.length(), (size_t)5);
+    EXPECT_EQ("File!", responseText.substr(responseText.length() - 5));
+    (void)remove(filePath.c_str());
+}
+
+TEST_F(ServerTests, CacheableResponseServedFromCacheUntilExpired) {
+    // Arrange
+    auto transport = std::make_shared< MockTransport >();
+    const auto timeKeeper = std::make_shared< MockTimeKeeper >();
+    Http::Server::MobilizationDependencies deps;
+    deps.transport = transport;
+    deps.timeKeeper = timeKeeper;
+    (void)server.Mobilize(deps);
+    size_t handlerCalls = 0;
+    const auto unregistrationDelegate = server.RegisterResource(
+        {"foo"},
+        [&handlerCalls](
+            const Http::Request& request,
+            std::shared_ptr< Http::Connection > connection,
+            const std::string& trailer
+        ){
+            ++handlerCalls;
+            Http::Response response;
+            response.statusCode = 200;
+            response.reasonPhrase = "OK";
+            response.headers.SetHeader("Cache-Control", "max-age=10");
+            response.body = "Hello!";
+            return response;
+        }
+    );
+    auto connection = std::make_shared< MockConnection >();
+    transport->connectionDelegate(connection);
+    const std::string request = (
+        "GET /foo HTTP/1.1\r\n"
+        "Host: www.example.com\r\n"
+        "\r\n"
+    );
+    const auto sendRequest = [&connection, &request]{
+        connection->dataReceived.clear();
+        connection->dataReceivedDelegate(
+            std::vector< uint8_t >(
+                request.begin(),
+                request.end()
+            )
+        );
+    };
+
+    // Act
+    sendRequest();
+    const std::string firstResponse(
+        connection->dataReceived.begin(),
+        connection->dataReceived.end()
+    );
+    sendRequest();
+    const std::string secondResponse(
+        connection->dataReceived.begin(),
+        connection->dataReceived.end()
+    );
+    const auto handlerCallsBeforeExpiration = handlerCalls;
+    timeKeeper->currentTime = 11.0;
+    sendRequest();
+
+    // Assert
+    EXPECT_EQ((size_t)1, handlerCallsBeforeExpiration);
+    EXPECT_EQ(firstResponse, secondResponse);
+    EXPECT_EQ((size_t)2, handlerCalls);
+    const auto snapshot = server.GetMetricsSnapshot();
+    EXPECT_EQ((size_t)1, snapshot.responseCacheHits);
+    EXPECT_EQ((size_t)2, snapshot.responseCacheMisses);
+    EXPECT_EQ((size_t)3, snapshot.responsesSuccess);
+}
+
+TEST_F(ServerTests, BannedClientDossiersSurviveEviction) {
+    // Arrange
+    auto transport = std::make_shared< MockTransport >();
+    const auto timeKeeper = std::make_shared< MockTimeKeeper >();
+    Http::Server::MobilizationDependencies deps;
+    deps.transport = transport;
+    deps.timeKeeper = timeKeeper;
+    server.SetConfigurationItem("MaxClientDossiers", "2");
+    (void)server.Mobilize(deps);
+    server.Ban("bad-client", "because I feel like it");
+
+    // Act
+    for (size_t i = 0; i < 5; ++i) {
+        const auto connection = std::make_shared< MockConnection >();
+        connection->peerAddress = StringExtensions::sprintf("client-%zu", i);
+        transport->connectionDelegate(connection);
+        EXPECT_FALSE(connection->broken) << i;
+    }
+
+    // Assert
+    EXPECT_EQ(
+        std::set< std::string >({
+            "bad-client"
+        }),
+        server.GetBans()
+    );
+    const auto connection = std::make_shared< MockConnection >();
+    connection->peerAddress = "bad-client";
+    transport->connectionDelegate(connection);
+    EXPECT_TRUE(connection->broken);
+}
+
 TEST_F(ServerTests, BanNotListedIfBanTimedOut) {
     // Arrange
     auto transport = std::make_shared< MockTransport >();